@@ -1,8 +1,25 @@
+// Server mode needs POSIX sockets, threads and open_memstream, plus Linux epoll/accept4
+#define _GNU_SOURCE
+
 #include "ex6.h"
 #include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <sched.h>
+#include <pthread.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
 
 # define INT_BUFFER 128
 
@@ -11,7 +28,7 @@
 //   PokemonData { int id; char *name; PokemonType TYPE; int hp; int attack; EvolutionStatus CAN_EVOLVE; }
 //   PokemonNode { PokemonData* data; PokemonNode* left, *right; }
 //   OwnerNode   { char* ownerName; PokemonNode* pokedexRoot; OwnerNode *next, *prev; }
-//   OwnerNode* ownerHead;
+//   OwnerShard ownerShards[OWNER_SHARDS];  (a ring + name index per shard, section 24)
 //   const PokemonData pokedex[];
 // ================================================
 
@@ -109,6 +126,45 @@ int readIntSafe(const char *prompt)
     return value;
 }
 
+int readSpeciesSafe(const char *prompt)
+{
+    char buffer[INT_BUFFER];
+
+    while (1)
+    {
+        printf("%s", prompt);
+
+        if (!fgets(buffer, sizeof(buffer), stdin))
+        {
+            printf("Invalid input.\n");
+            clearerr(stdin);
+            continue;
+        }
+
+        // Drop the line ending, then surrounding blanks so " Mr. Mime " still matches
+        buffer[strcspn(buffer, "\r\n")] = '\0';
+        trimWhitespace(buffer);
+        if (buffer[0] == '\0')
+        {
+            printf("Invalid input.\n");
+            continue;
+        }
+
+        // A plain number is taken as an ID, exactly like readIntSafe
+        char *endptr;
+        int value = (int)strtol(buffer, &endptr, 10);
+        if (*endptr == '\0')
+            return value;
+
+        // Otherwise try it as a species name
+        value = findSpeciesByName(buffer);
+        if (value)
+            return value;
+
+        printf("Invalid input.\n");
+    }
+}
+
 // --------------------------------------------------------------
 // 2) Utility: Get type name from enum
 // --------------------------------------------------------------
@@ -192,10 +248,21 @@ char *getDynamicInput()
 
 // Function to print a single Pokemon node
 void printPokemonNode(PokemonNode *node)
+{
+    writePokemonNode(stdout, node);
+}
+
+/**
+ * @brief Write one PokemonNode's data in the printPokemonNode format.
+ * @param out stream to write to
+ * @param node pointer to the node
+ * Why we made it: Server replies need the same line, just not on stdout.
+ */
+void writePokemonNode(FILE *out, const PokemonNode *node)
 {
     if (!node)
         return;
-    printf("ID: %d, Name: %s, Type: %s, HP: %d, Attack: %d, Can Evolve: %s\n",
+    fprintf(out, "ID: %d, Name: %s, Type: %s, HP: %d, Attack: %d, Can Evolve: %s\n",
            node->data->id,
            node->data->name,
            getTypeName(node->data->TYPE),
@@ -216,21 +283,23 @@ void printPokemonNode(PokemonNode *node)
  */
 PokemonNode *createPokemonNode(const PokemonData *data) {
 
-    PokemonNode* root = malloc(sizeof(PokemonNode));
+    PokemonNode* root = arenaAlloc(sizeof(PokemonNode));
     if (root == NULL) {
         return NULL;
     }
     root->data = data;
     root->left = NULL;
     root->right = NULL;
+    root->dead = 0;
+    root->refs = 1;
     return root;
 }
 
 /**
  * @brief Create an OwnerNode for the circular owners list.
- * @param ownerName the dynamically allocated name
+ * @param ownerName the dynamically allocated name (copied into the arena and freed on success)
  * @param starter BST root for the starter Pokemon
- * @return newly allocated OwnerNode*
+ * @return newly allocated OwnerNode*, or NULL (ownerName untouched) on failure
  * Why we made it: Each user is represented as an OwnerNode.
  */
 OwnerNode *createOwner(char *ownerName, PokemonNode *starter) {
@@ -238,16 +307,32 @@ OwnerNode *createOwner(char *ownerName, PokemonNode *starter) {
     if (ownerName == NULL)
         return NULL;
 
-    OwnerNode *newOwnerNode = malloc(sizeof(OwnerNode));
+    OwnerNode *newOwnerNode = arenaAlloc(sizeof(OwnerNode));
 
     if (!newOwnerNode) {
         return newOwnerNode;
     }
 
-    newOwnerNode->ownerName = ownerName;
+    newOwnerNode->ownerName = arenaStrdup(ownerName);
+    if (!newOwnerNode->ownerName) {
+        arenaFree(newOwnerNode, sizeof(OwnerNode));
+        return NULL;
+    }
+    free(ownerName);
     newOwnerNode->pokedexRoot = starter;
     newOwnerNode->next = newOwnerNode;
     newOwnerNode->prev = newOwnerNode;
+    newOwnerNode->frozen = NULL;
+    newOwnerNode->snapshot = NULL;
+    newOwnerNode->hasSnapshot = 0;
+    newOwnerNode->engineCopy = NULL;
+    newOwnerNode->engineSnapshot = NULL;
+    newOwnerNode->lazyRelease = 0;
+    newOwnerNode->deadCount = 0;
+    newOwnerNode->deadCheckAt = 0;
+    newOwnerNode->merged = 0;
+    newOwnerNode->viewSlot = NULL;
+    pthread_mutex_init(&newOwnerNode->lock, NULL);
     return newOwnerNode;
 }
 
@@ -261,23 +346,93 @@ OwnerNode *createOwner(char *ownerName, PokemonNode *starter) {
 void freePokemonNode(PokemonNode *node) {
     //free(node->data);
     node->data = NULL;
-    free(node);
+    arenaFree(node, sizeof(PokemonNode));
 }
 
 /**
- * @brief Recursively free a BST of PokemonNodes.
- * @param root BST root
- * Why we made it: Clearing a user’s entire Pokedex means freeing a tree.
+ * @brief Drop one reference to a BST; nodes no other tree shares are freed.
+ * @param root BST root (may be NULL)
+ * Why we made it: Clearing a user’s entire Pokedex means freeing a tree, however degenerate,
+ * while leaving the parts an undo snapshot or a clone still uses.
  */
 void freePokemonTree(PokemonNode *root) {
-    if (root == NULL) {
-        return;
+
+    // Shared nodes can't be rotated, so walk with a stack. A node is pushed only when its
+    // one parent in this tree is freed, so the stack never outgrows the species count.
+    PokemonNode *stack[POKEDEX_SIZE];
+    int depth = 0;
+    if (root != NULL)
+        stack[depth++] = root;
+    while (depth > 0) {
+        PokemonNode *node = stack[--depth];
+        if (--node->refs > 0)
+            continue;
+        // A freed node hands its child references down
+        if (node->left != NULL)
+            stack[depth++] = node->left;
+        if (node->right != NULL)
+            stack[depth++] = node->right;
+        freePokemonNode(node);
     }
-    freePokemonTree(root->left);
-    root->left = NULL;
-    freePokemonTree(root->right);
-    root->right = NULL;
-    freePokemonNode(root);
+}
+
+/**
+ * @brief Take one more reference to a BST, sharing every node (O(1)).
+ * @param root BST root (may be NULL)
+ * @return root, for chaining
+ * Why we made it: Undo snapshots, clones and disjoint merges share nodes instead of copying them.
+ */
+PokemonNode *retainPokemonTree(PokemonNode *root) {
+
+    if (root != NULL)
+        root->refs++;
+    return root;
+}
+
+// Make a node reached through an owned link safe to write: a shared node is replaced by
+// a copy holding its own references to the children, which moves the sharing one level
+// down. Returns NULL if out of memory.
+static PokemonNode *ownPokemonNode(PokemonNode *node) {
+
+    if (node->refs == 1)
+        return node;
+
+    PokemonNode *copy = createPokemonNode(node->data);
+    if (copy == NULL)
+        return NULL;
+    copy->dead = node->dead;
+    copy->left = retainPokemonTree(node->left);
+    copy->right = retainPokemonTree(node->right);
+    node->refs--;
+    return copy;
+}
+
+/**
+ * @brief Copy every node of a BST that another tree shares.
+ * @param root pointer to the BST root (updated)
+ * @return 1 on success, 0 if out of memory (the tree is still valid, just partly shared)
+ * Why we made it: Bulk operations rewrite nodes in place and relink them, which must not
+ * show through in a snapshot or a clone.
+ */
+int unsharePokemonTree(PokemonNode **root) {
+
+    // Top-down, so copying a parent has already bumped its children's counts
+    PokemonNode **stack[POKEDEX_SIZE];
+    int depth = 0;
+    if (*root != NULL)
+        stack[depth++] = root;
+    while (depth > 0) {
+        PokemonNode **link = stack[--depth];
+        PokemonNode *node = ownPokemonNode(*link);
+        if (node == NULL)
+            return 0;
+        *link = node;
+        if (node->left != NULL)
+            stack[depth++] = &node->left;
+        if (node->right != NULL)
+            stack[depth++] = &node->right;
+    }
+    return 1;
 }
 
 /**
@@ -286,10 +441,14 @@ void freePokemonTree(PokemonNode *root) {
  * Why we made it: Deleting an owner also frees their Pokedex & name.
  */
 void freeOwnerNode(OwnerNode *owner) {
-    free(owner->ownerName);
+    thawPokedex(owner);
+    dropEngineSnapshot(owner);
+    freePokemonTree(owner->snapshot);
+    arenaFree(owner->ownerName, strlen(owner->ownerName) + 1);
     freePokemonTree(owner->pokedexRoot);
     owner->pokedexRoot = NULL;
-    free(owner);
+    pthread_mutex_destroy(&owner->lock);
+    arenaFree(owner, sizeof(OwnerNode));
 }
 
 
@@ -359,10 +518,24 @@ PokemonNode *insertPokemonNode(PokemonNode *root, PokemonNode *newNode) {
     }
 
     // If the ID already exists, don't insert (no duplicates allowed) and free the Node.
+    // A tombstone for that ID comes back to life instead.
     if (newNode->data->id == root->data->id) {
+        PokemonNode *owned = root->dead ? ownPokemonNode(root) : NULL;
+        if (owned != NULL) {
+            owned->dead = 0;
+            root = owned;
+        }
+        freePokemonNode(newNode);
+        return root;
+    }
+
+    // A node another tree shares is copied before one of its links changes
+    PokemonNode *owned = ownPokemonNode(root);
+    if (owned == NULL) {
         freePokemonNode(newNode);
         return root;
     }
+    root = owned;
 
     // Recursively insert into the appropriate subtree
     if (newNode->data->id < root->data->id) {
@@ -374,6 +547,22 @@ PokemonNode *insertPokemonNode(PokemonNode *root, PokemonNode *newNode) {
     return root;
 }
 
+// What searchPokemonBFS looks for, and the node once found
+typedef struct {
+    int id;
+    PokemonNode *found;
+} SearchByID;
+
+// Stops the walk at the first node with the wanted ID
+static TraverseResult visitSearchByID(PokemonNode *node, void *ctx) {
+
+    SearchByID *search = ctx;
+    if (node->data->id != search->id)
+        return TRAVERSE_CONTINUE;
+    search->found = node;
+    return TRAVERSE_STOP;
+}
+
 /**
  * @brief BFS search for a Pokemon by ID in the BST.
  * @param root BST root
@@ -381,30 +570,25 @@ PokemonNode *insertPokemonNode(PokemonNode *root, PokemonNode *newNode) {
  * @return pointer to found node or NULL
  * Why we made it: BFS ensures we find nodes even in an unbalanced tree.
  */
-// Queue structure for BFS
 PokemonNode *searchPokemonBFS(PokemonNode *root, int id) {
 
-    if (root == NULL) {
-        return NULL;
-    }
-
-    Queue* q = createQueue();
-    enqueue(q, root);
+    SearchByID search = {id, NULL};
+    BFSGenericCtx(root, visitSearchByID, &search);
+    return search.found;  // NULL if Pokemon not found
+}
 
-    while (q->front != NULL) {
-        PokemonNode* current = dequeue(q);
-        if (current->data->id == id) {
-            free(q);
-            return current;
-        }
-        if (current->left)
-            enqueue(q, current->left);
-        if (current->right)
-            enqueue(q, current->right);
-    }
+/**
+ * @brief Search for a Pokemon by ID by descending the BST (O(height)).
+ * @param root BST root
+ * @param id ID to find
+ * @return pointer to found node or NULL
+ * Why we made it: Membership checks for many candidate IDs shouldn't each walk the whole tree.
+ */
+PokemonNode *searchPokemonBST(PokemonNode *root, int id) {
 
-    free(q);
-    return NULL;  // Pokemon not found
+    while (root != NULL && root->data->id != id)
+        root = (id < root->data->id) ? root->left : root->right;
+    return (root != NULL && !root->dead) ? root : NULL;
 }
 
 PokemonNode* findMin(PokemonNode* node) {
@@ -426,6 +610,12 @@ PokemonNode *removeNodeBST(PokemonNode *root, int id) {
         return root;
     }
 
+    // A node another tree shares is copied before anything in it changes
+    PokemonNode *owned = ownPokemonNode(root);
+    if (owned == NULL)
+        return root;
+    root = owned;
+
     if (id < root->data->id)
         root->left = removeNodeBST(root->left, id);
     else if (id > root->data->id)
@@ -445,6 +635,7 @@ PokemonNode *removeNodeBST(PokemonNode *root, int id) {
         // Node with two children
         PokemonNode *temp = findMin(root->right);
         root->data = temp->data;
+        root->dead = temp->dead;
         root->right = removeNodeBST(root->right, temp->data->id);
     }
     return root;
@@ -465,24 +656,262 @@ PokemonNode *removePokemonByID(PokemonNode *root, int id) {
     return root;
 }
 
+/**
+ * @brief Link an ID-sorted array of existing nodes into a height-balanced BST.
+ * @param nodes array of node pointers sorted by ascending ID (no duplicates, none shared)
+ * @param count number of nodes in the array
+ * @return root of the rebuilt BST
+ * Why we made it: Bulk operations rebuild the tree once instead of re-inserting node by node.
+ */
+PokemonNode *buildBalancedTree(PokemonNode **nodes, int count) {
+
+    if (count <= 0)
+        return NULL;
+
+    int mid = count / 2;
+    PokemonNode *root = nodes[mid];
+    root->left = buildBalancedTree(nodes, mid);
+    root->right = buildBalancedTree(nodes + mid + 1, count - mid - 1);
+    return root;
+}
+
+/**
+ * @brief Tombstone a Pokemon by ID instead of unlinking it (O(height)).
+ * @param root pointer to the BST root (updated when shared nodes on the path are copied)
+ * @param id ID to mark
+ * @return 1 if a live node was marked, 0 if not found, already dead or out of memory
+ * Why we made it: Releasing many Pokemon in a burst shouldn't restructure the tree each time.
+ */
+int markPokemonDead(PokemonNode **root, int id) {
+
+    PokemonNode *node = *root;
+    while (node != NULL && node->data->id != id)
+        node = (id < node->data->id) ? node->left : node->right;
+    if (node == NULL || node->dead)
+        return 0;
+
+    // Walk the path again, copying whatever another tree shares
+    PokemonNode **link = root;
+    for (;;) {
+        node = ownPokemonNode(*link);
+        if (node == NULL)
+            return 0;
+        *link = node;
+        if (node->data->id == id)
+            break;
+        link = (id < node->data->id) ? &node->left : &node->right;
+    }
+    node->dead = 1;
+    return 1;
+}
+
+/**
+ * @brief Free every tombstoned node and relink the rest into a balanced BST.
+ * @param root BST root
+ * @return updated BST root (unchanged if there was nothing to purge or no memory)
+ * Why we made it: One rebuild pays for a whole burst of lazy releases.
+ */
+PokemonNode *purgeDeadNodes(PokemonNode *root) {
+
+    if (root == NULL || !unsharePokemonTree(&root))
+        return root;
+
+    // Sized for every possible species, so no addNode below has to grow it
+    NodeArray live;
+    live.nodes = NULL;
+    initNodeArray(&live, POKEDEX_SIZE);
+    if (!live.nodes)
+        return root;
+
+    // Rotate into a right-leaning vine (as freePokemonTree does), which lists nodes in ID order
+    PokemonNode vine;
+    vine.right = root;
+    PokemonNode *tail = &vine;
+    PokemonNode *rest = root;
+    while (rest != NULL) {
+        if (rest->left != NULL) {
+            PokemonNode *left = rest->left;
+            rest->left = left->right;
+            left->right = rest;
+            rest = left;
+            tail->right = left;
+        } else {
+            tail = rest;
+            rest = rest->right;
+        }
+    }
+
+    for (PokemonNode *node = vine.right; node != NULL; ) {
+        PokemonNode *next = node->right;
+        if (node->dead)
+            freePokemonNode(node);
+        else
+            addNode(&live, node);
+        node = next;
+    }
+
+    root = buildBalancedTree(live.nodes, live.size);
+    destroyNodeArray(&live);
+    return root;
+}
+
 /* ------------------------------------------------------------
    4) Generic BST Traversals (Function Pointers)
    ------------------------------------------------------------ */
 
+/*
+ * The depth-first walkers below are iterative: a NodeArray serves as an explicit
+ * heap-allocated stack, so a degenerate (list-shaped) tree can't overflow the C stack.
+ * IDs are unique, so a tree never holds more than POKEDEX_SIZE nodes: a stack (or
+ * array queue) that size never has to grow, and no push can fail halfway through a walk.
+ */
+#define WALK_STACK_SIZE POKEDEX_SIZE
+
+static int initWalkStack(NodeArray *stack) {
+
+    stack->nodes = NULL;
+    initNodeArray(stack, WALK_STACK_SIZE);
+    return stack->nodes != NULL;
+}
+
+static PokemonNode *popNode(NodeArray *stack) {
+
+    return stack->size > 0 ? stack->nodes[--stack->size] : NULL;
+}
+
+/*
+ * Compile-time specialized walkers. DEFINE_*_WALK(name, CtxType, VISIT) stamps out
+ * `static void name(PokemonNode *root, CtxType ctx)` with VISIT(node, ctx) pasted into
+ * the loop, so hot visitors (print, count) are direct calls the compiler can
+ * inline instead of an indirect call per node. The function-pointer walkers further
+ * down stay for everything else. Every walker passes over tombstoned (dead) nodes.
+ */
+#define DEFINE_BFS_WALK(name, CtxType, VISIT)                           \
+    static void name(PokemonNode *root, CtxType ctx)                    \
+    {                                                                   \
+        (void)ctx;                                                      \
+        NodeArray queue;                                                \
+        if (root == NULL || !initWalkStack(&queue))                     \
+            return;                                                     \
+        /* Array queue: append at size, consume from head */            \
+        addNode(&queue, root);                                          \
+        for (int head = 0; head < queue.size; head++)                   \
+        {                                                               \
+            PokemonNode *current = queue.nodes[head];                   \
+            if (!current->dead)                                         \
+                VISIT(current, ctx);                                    \
+            if (current->left)                                          \
+                addNode(&queue, current->left);                         \
+            if (current->right)                                         \
+                addNode(&queue, current->right);                        \
+        }                                                               \
+        destroyNodeArray(&queue);                                       \
+    }
+
+#define DEFINE_PREORDER_WALK(name, CtxType, VISIT)                      \
+    static void name(PokemonNode *root, CtxType ctx)                    \
+    {                                                                   \
+        (void)ctx;                                                      \
+        NodeArray stack;                                                \
+        if (root == NULL || !initWalkStack(&stack))                     \
+            return;                                                     \
+        addNode(&stack, root);                                          \
+        while (stack.size > 0)                                          \
+        {                                                               \
+            PokemonNode *current = popNode(&stack);                     \
+            if (!current->dead)                                         \
+                VISIT(current, ctx);                                    \
+            if (current->right)                                         \
+                addNode(&stack, current->right);                        \
+            if (current->left)                                          \
+                addNode(&stack, current->left);                         \
+        }                                                               \
+        destroyNodeArray(&stack);                                       \
+    }
+
+#define DEFINE_INORDER_WALK(name, CtxType, VISIT)                       \
+    static void name(PokemonNode *root, CtxType ctx)                    \
+    {                                                                   \
+        (void)ctx;                                                      \
+        NodeArray stack;                                                \
+        if (root == NULL || !initWalkStack(&stack))                     \
+            return;                                                     \
+        PokemonNode *current = root;                                    \
+        while (current != NULL || stack.size > 0)                       \
+        {                                                               \
+            while (current != NULL)                                     \
+            {                                                           \
+                addNode(&stack, current);                               \
+                current = current->left;                                \
+            }                                                           \
+            current = popNode(&stack);                                  \
+            if (!current->dead)                                         \
+                VISIT(current, ctx);                                    \
+            current = current->right;                                   \
+        }                                                               \
+        destroyNodeArray(&stack);                                       \
+    }
+
+#define DEFINE_POSTORDER_WALK(name, CtxType, VISIT)                     \
+    static void name(PokemonNode *root, CtxType ctx)                    \
+    {                                                                   \
+        (void)ctx;                                                      \
+        NodeArray stack;                                                \
+        if (root == NULL || !initWalkStack(&stack))                     \
+            return;                                                     \
+        PokemonNode *current = root;                                    \
+        PokemonNode *lastVisited = NULL;                                \
+        while (current != NULL || stack.size > 0)                       \
+        {                                                               \
+            while (current != NULL)                                     \
+            {                                                           \
+                addNode(&stack, current);                               \
+                current = current->left;                                \
+            }                                                           \
+            PokemonNode *top = stack.nodes[stack.size - 1];             \
+            if (top->right != NULL && top->right != lastVisited)        \
+                current = top->right;                                   \
+            else                                                        \
+            {                                                           \
+                if (!top->dead)                                         \
+                    VISIT(top, ctx);                                    \
+                lastVisited = popNode(&stack);                          \
+            }                                                           \
+        }                                                               \
+        destroyNodeArray(&stack);                                       \
+    }
+
+#define VISIT_PRINT(node, ctx) printPokemonNode(node)
+#define VISIT_COUNT(node, ctx) ((*(ctx))++)
+
+DEFINE_BFS_WALK(bfsPrintWalk, void *, VISIT_PRINT)
+DEFINE_PREORDER_WALK(preOrderPrintWalk, void *, VISIT_PRINT)
+DEFINE_INORDER_WALK(inOrderPrintWalk, void *, VISIT_PRINT)
+DEFINE_POSTORDER_WALK(postOrderPrintWalk, void *, VISIT_PRINT)
+DEFINE_PREORDER_WALK(preOrderCountWalk, int *, VISIT_COUNT)
+
 // Please notice, it's not really generic, it's just a demonstration of function pointers.
 // so don't be confused by the name, but please remember that you must use it.
 
+static void destroyQueue(Queue *q) {
+
+    while (q->front != NULL)
+        dequeue(q);
+    free(q);
+}
 
 /**
- * @brief Generic BFS traversal: call visit() on each node (level-order).
+ * @brief BFS traversal with a user context; stops as soon as visit() says so.
  * @param root BST root
- * @param visit function pointer for what to do with each node
- * Why we made it: BFS plus function pointers => flexible traversal.
+ * @param visit callback receiving each node and ctx
+ * @param ctx caller data handed to every visit() call
+ * @return TRAVERSE_STOP if visit() ended the walk early, else TRAVERSE_CONTINUE
+ * Why we made it: Searches and aggregations need state and an early exit, not globals.
  */
-void BFSGeneric(PokemonNode *root, VisitNodeFunc visit) {
+TraverseResult BFSGenericCtx(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx) {
 
     if (root == NULL)
-        return;
+        return TRAVERSE_CONTINUE;
 
     Queue* q = createQueue();
     enqueue(q, root);
@@ -490,8 +919,10 @@ void BFSGeneric(PokemonNode *root, VisitNodeFunc visit) {
     while (q->front != NULL) {
         PokemonNode* current = dequeue(q);
 
-        // Call the visit function on the current node
-        visit(current);
+        if (!current->dead && visit(current, ctx) == TRAVERSE_STOP) {
+            destroyQueue(q);
+            return TRAVERSE_STOP;
+        }
 
         if (current->left)
             enqueue(q, current->left);
@@ -500,45 +931,165 @@ void BFSGeneric(PokemonNode *root, VisitNodeFunc visit) {
     }
 
     free(q);
+    return TRAVERSE_CONTINUE;
 }
 
 /**
- * @brief A generic pre-order traversal (Root-Left-Right).
+ * @brief Pre-order traversal (Root-Left-Right) with a user context and early exit.
  * @param root BST root
- * @param visit function pointer
- * Why we made it: Another demonstration of function-pointer-based traversal.
+ * @param visit callback receiving each node and ctx
+ * @param ctx caller data handed to every visit() call
+ * @return TRAVERSE_STOP if visit() ended the walk early, else TRAVERSE_CONTINUE
+ * Why we made it: Same as BFSGenericCtx, in depth-first order.
  */
-void preOrderGeneric(PokemonNode *root, VisitNodeFunc visit) {
+TraverseResult preOrderGenericCtx(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx) {
 
-    if (root == NULL) {
-        return;
+    NodeArray stack;
+    if (root == NULL || !initWalkStack(&stack)) {
+        return TRAVERSE_CONTINUE;
+    }
+
+    TraverseResult result = TRAVERSE_CONTINUE;
+    addNode(&stack, root);
+    while (stack.size > 0) {
+        PokemonNode *current = popNode(&stack);
+        if (!current->dead && visit(current, ctx) == TRAVERSE_STOP) {
+            result = TRAVERSE_STOP;
+            break;
+        }
+
+        // Push right first so the left subtree is visited first
+        if (current->right)
+            addNode(&stack, current->right);
+        if (current->left)
+            addNode(&stack, current->left);
     }
 
-    visit(root);
+    destroyNodeArray(&stack);
+    return result;
+}
+
+/**
+ * @brief In-order traversal (Left-Root-Right) with a user context and early exit.
+ * @param root BST root
+ * @param visit callback receiving each node and ctx
+ * @param ctx caller data handed to every visit() call
+ * @return TRAVERSE_STOP if visit() ended the walk early, else TRAVERSE_CONTINUE
+ * Why we made it: Ascending-ID walks that can stop once they have what they need.
+ */
+TraverseResult inOrderGenericCtx(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx) {
+
+    NodeArray stack;
+    if (root == NULL || !initWalkStack(&stack)) {
+        return TRAVERSE_CONTINUE;
+    }
 
-    preOrderGeneric(root->left, visit);
+    TraverseResult result = TRAVERSE_CONTINUE;
+    PokemonNode *current = root;
+    while (current != NULL || stack.size > 0) {
+        // Go as far left as possible, remembering the way back
+        while (current != NULL) {
+            addNode(&stack, current);
+            current = current->left;
+        }
+        current = popNode(&stack);
+        if (!current->dead && visit(current, ctx) == TRAVERSE_STOP) {
+            result = TRAVERSE_STOP;
+            break;
+        }
+        current = current->right;
+    }
 
-    preOrderGeneric(root->right, visit);
+    destroyNodeArray(&stack);
+    return result;
 }
 
 /**
- * @brief A generic in-order traversal (Left-Root-Right).
+ * @brief Post-order traversal (Left-Right-Root) with a user context and early exit.
  * @param root BST root
- * @param visit function pointer
- * Why we made it: Great for seeing sorted order if BST is sorted by ID.
+ * @param visit callback receiving each node and ctx
+ * @param ctx caller data handed to every visit() call
+ * @return TRAVERSE_STOP if visit() ended the walk early, else TRAVERSE_CONTINUE
+ * Why we made it: Children-before-parent walks with state and an early exit.
  */
-void inOrderGeneric(PokemonNode *root, VisitNodeFunc visit) {
+TraverseResult postOrderGenericCtx(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx) {
 
-    if (root == NULL) {
-        return;
+    NodeArray stack;
+    if (root == NULL || !initWalkStack(&stack)) {
+        return TRAVERSE_CONTINUE;
+    }
+
+    TraverseResult result = TRAVERSE_CONTINUE;
+    PokemonNode *current = root;
+    PokemonNode *lastVisited = NULL;
+    while (current != NULL || stack.size > 0) {
+        while (current != NULL) {
+            addNode(&stack, current);
+            current = current->left;
+        }
+        PokemonNode *top = stack.nodes[stack.size - 1];
+
+        // Visit a node only once its right subtree is done
+        if (top->right != NULL && top->right != lastVisited) {
+            current = top->right;
+        } else {
+            if (!top->dead && visit(top, ctx) == TRAVERSE_STOP) {
+                result = TRAVERSE_STOP;
+                break;
+            }
+            lastVisited = popNode(&stack);
+        }
     }
 
+    destroyNodeArray(&stack);
+    return result;
+}
+
+// The plain VisitNodeFunc walkers run on the context walkers with this adapter
+typedef struct {
+    VisitNodeFunc visit;
+} PlainVisit;
+
+static TraverseResult visitPlain(PokemonNode *node, void *ctx) {
+
+    ((PlainVisit *)ctx)->visit(node);
+    return TRAVERSE_CONTINUE;
+}
+
+/**
+ * @brief Generic BFS traversal: call visit() on each node (level-order).
+ * @param root BST root
+ * @param visit function pointer for what to do with each node
+ * Why we made it: BFS plus function pointers => flexible traversal.
+ */
+void BFSGeneric(PokemonNode *root, VisitNodeFunc visit) {
+
+    PlainVisit plain = {visit};
+    BFSGenericCtx(root, visitPlain, &plain);
+}
+
+/**
+ * @brief A generic pre-order traversal (Root-Left-Right).
+ * @param root BST root
+ * @param visit function pointer
+ * Why we made it: Another demonstration of function-pointer-based traversal.
+ */
+void preOrderGeneric(PokemonNode *root, VisitNodeFunc visit) {
 
-    preOrderGeneric(root->left, visit);
+    PlainVisit plain = {visit};
+    preOrderGenericCtx(root, visitPlain, &plain);
+}
 
-    visit(root);
+/**
+ * @brief A generic in-order traversal (Left-Root-Right).
+ * @param root BST root
+ * @param visit function pointer
+ * Why we made it: Great for seeing sorted order if BST is sorted by ID.
+ */
+void inOrderGeneric(PokemonNode *root, VisitNodeFunc visit) {
 
-    preOrderGeneric(root->right, visit);
+    PlainVisit plain = {visit};
+    inOrderGenericCtx(root, visitPlain, &plain);
 }
 
 /**
@@ -549,16 +1100,50 @@ void inOrderGeneric(PokemonNode *root, VisitNodeFunc visit) {
  */
 void postOrderGeneric(PokemonNode *root, VisitNodeFunc visit) {
 
-    if (root == NULL) {
-        return;
-    }
-
-
-    preOrderGeneric(root->left, visit);
+    PlainVisit plain = {visit};
+    postOrderGenericCtx(root, visitPlain, &plain);
+}
 
-    preOrderGeneric(root->right, visit);
+/**
+ * @brief In-order traversal with O(1) extra space (Morris threading) and early exit.
+ * @param root BST root
+ * @param visit callback receiving each node and ctx (must not modify the tree)
+ * @param ctx caller data handed to every visit() call
+ * @return TRAVERSE_STOP if visit() ended the walk early, else TRAVERSE_CONTINUE
+ * Why we made it: No stack at all, so nothing to allocate and nothing to fail; the tree
+ * is temporarily threaded and restored as we go, so no one else may read it meanwhile.
+ */
+TraverseResult inOrderMorrisCtx(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx) {
+
+    // After a stop the walk runs on without visiting, to take every thread back out
+    TraverseResult result = TRAVERSE_CONTINUE;
+    PokemonNode *current = root;
+    while (current != NULL) {
+        if (current->left == NULL) {
+            if (result == TRAVERSE_CONTINUE && !current->dead)
+                result = visit(current, ctx);
+            current = current->right;
+            continue;
+        }
 
-    visit(root);
+        // Find the in-order predecessor: rightmost node of the left subtree
+        PokemonNode *pred = current->left;
+        while (pred->right != NULL && pred->right != current)
+            pred = pred->right;
+
+        if (pred->right == NULL) {
+            // Thread the predecessor back to us, then descend left
+            pred->right = current;
+            current = current->left;
+        } else {
+            // Second arrival through the thread: undo it and visit
+            pred->right = NULL;
+            if (result == TRAVERSE_CONTINUE && !current->dead)
+                result = visit(current, ctx);
+            current = current->right;
+        }
+    }
+    return result;
 }
 
 /* ------------------------------------------------------------
@@ -596,33 +1181,52 @@ void destroyNodeArray(NodeArray *na) {
  * @brief Add a PokemonNode pointer to NodeArray, realloc if needed.
  * @param na pointer to NodeArray
  * @param node pointer to the node
+ * @return 1 if added, 0 if the array couldn't grow (na is left unchanged)
  * Why we made it: We want a dynamic list of BST nodes for sorting.
  */
-void addNode(NodeArray *na, PokemonNode *node) {
-    if (na == NULL || node == NULL)
-        return;
+int addNode(NodeArray *na, PokemonNode *node) {
+    if (na == NULL || node == NULL || na->nodes == NULL)
+        return 0;
     if (na->size == na->capacity) {
-        na->nodes = realloc(na->nodes, na->capacity * 2);
+        PokemonNode **grown = realloc(na->nodes, na->capacity * 2 * sizeof(PokemonNode *));
+        if (!grown)
+            return 0;
+        na->nodes = grown;
         na->capacity *= 2;
     }
     na->nodes[na->size++] = node;
+    return 1;
+}
+
+static TraverseResult visitCollect(PokemonNode *node, void *ctx) {
+
+    return addNode(ctx, node) ? TRAVERSE_CONTINUE : TRAVERSE_STOP;
 }
 
 /**
- * @brief Recursively collect all nodes from the BST into a NodeArray.
+ * @brief Collect all nodes from the BST into a NodeArray, in ID order.
  * @param root BST root
  * @param na pointer to NodeArray
- * Why we made it: We gather everything for qsort.
+ * @return 1 if every node was collected, 0 if the array ran out of memory
+ * Why we made it: Bulk operations work on the nodes as one sorted array; the Morris walk
+ * needs no stack, so with the array sized up front nothing can fail.
  */
-void collectAll(PokemonNode *root, NodeArray *na)  {
+int collectAll(PokemonNode *root, NodeArray *na)  {
 
-    if (root == NULL)
-        return;
+    return inOrderMorrisCtx(root, visitCollect, na) == TRAVERSE_CONTINUE;
+}
 
-    collectAll(root->left, na);
-    addNode(na, root);
-    collectAll(root->right, na);
+/**
+ * @brief Count the nodes of a BST.
+ * @param root BST root
+ * @return number of nodes
+ * Why we made it: Lets bulk operations size their arrays exactly up front.
+ */
+int countPokemonNodes(PokemonNode *root) {
 
+    int count = 0;
+    preOrderCountWalk(root, &count);
+    return count;
 }
 
 /**
@@ -641,20 +1245,37 @@ int compareByNameNode(const void *a, const void *b) {
    return strcmp(pokemonA->data->name, pokemonB->data->name);
 }
 
+// Position of every species ID in name order (index 0 unused), filled by initSpeciesTables()
+static unsigned short speciesAlphaRank[POKEDEX_SIZE + 1];
+
+// Drop every node into the slot of its species' alphabetical rank (IDs are unique per tree)
+#define VISIT_BUCKET_BY_ALPHA_RANK(node, byRank) ((byRank)[speciesAlphaRank[(node)->data->id]] = (node))
+DEFINE_PREORDER_WALK(bucketByAlphaRankWalk, PokemonNode **, VISIT_BUCKET_BY_ALPHA_RANK)
+
 /**
- * @brief BFS is nice, but alphabetical means we gather all nodes, sort by name, then print.
+ * @brief Print Pokemon sorted by name, bucketing each node by its precomputed alphabetical rank.
  * @param root BST root
- * Why we made it: Provide user the option to see Pokemon sorted by name.
+ * Why we made it: Names are static, so one counting pass replaces gathering + qsort + strcmp.
  */
 void displayAlphabetical(PokemonNode *root) {
-    NodeArray na;
-    initNodeArray(&na, 50);
-    collectAll(root, &na);
-    qsort(na.nodes,  na.size, sizeof(PokemonNode *), compareByNameNode);
-    for (int i = 0; i < na.size; i++) {
-        printPokemonNode(na.nodes[i]);
+
+    writeAlphabetical(stdout, root);
+}
+
+/**
+ * @brief Write Pokemon sorted by name to a stream (see displayAlphabetical).
+ * @param out stream to write to
+ * @param root BST root
+ */
+void writeAlphabetical(FILE *out, PokemonNode *root) {
+
+    PokemonNode *byRank[POKEDEX_SIZE];
+    memset(byRank, 0, sizeof(byRank));
+    bucketByAlphaRankWalk(root, byRank);
+    for (int i = 0; i < POKEDEX_SIZE; i++) {
+        if (byRank[i])
+            writePokemonNode(out, byRank[i]);
     }
-    destroyNodeArray(&na);
 }
 
 /**
@@ -664,7 +1285,7 @@ void displayAlphabetical(PokemonNode *root) {
  */
 void displayBFS(PokemonNode *root) {
 
-    BFSGeneric(root, printPokemonNode);
+    bfsPrintWalk(root, NULL);
 }
 
 /**
@@ -674,7 +1295,7 @@ void displayBFS(PokemonNode *root) {
  */
 void preOrderTraversal(PokemonNode *root) {
 
-    preOrderGeneric(root, printPokemonNode);
+    preOrderPrintWalk(root, NULL);
 
 }
 
@@ -684,7 +1305,7 @@ void preOrderTraversal(PokemonNode *root) {
  * Why we made it: Good for sorted output by ID if the tree is a BST.
  */
 void inOrderTraversal(PokemonNode *root) {
-    inOrderGeneric(root, printPokemonNode);
+    inOrderPrintWalk(root, NULL);
 }
 
 /**
@@ -693,7 +1314,7 @@ void inOrderTraversal(PokemonNode *root) {
  * Why we made it: Another standard traversal pattern.
  */
 void postOrderTraversal(PokemonNode *root) {
-    postOrderGeneric(root, printPokemonNode);
+    postOrderPrintWalk(root, NULL);
 }
 
 /* ------------------------------------------------------------
@@ -715,30 +1336,29 @@ void pokemonFight(OwnerNode *owner) {
         return;
     }
 
-    PokemonNode *root = owner->pokedexRoot;
-    if (root == NULL) {
+    if (owner->pokedexRoot == NULL) {
         printf("Pokedex is empty.");
     }
 
-    int choice1 = readIntSafe("Enter ID of the first Pokemon: ");
-    int choice2 = readIntSafe("Enter ID of the second Pokemon: ");
+    int choice1 = readSpeciesSafe("Enter ID of the first Pokemon: ");
+    int choice2 = readSpeciesSafe("Enter ID of the second Pokemon: ");
 
-    PokemonNode *pokemon1 = searchPokemonBFS(root, choice1);
-    PokemonNode *pokemon2 = searchPokemonBFS(root, choice2);
+    const PokemonData *pokemon1 = ownerFindPokemon(owner, choice1);
+    const PokemonData *pokemon2 = ownerFindPokemon(owner, choice2);
 
     if (pokemon1 == NULL || pokemon2 == NULL) {
         printf("One or both Pokemon IDs not found.");
         return;
     }
 
-    float strength1 = pokemonCalcStregth(pokemon1->data);
-    float strength2 = pokemonCalcStregth(pokemon2->data);
-    printf("Pokemon 1: %s (Score = %f)",pokemon1->data->name, strength1);
-    printf("Pokemon 2: %s (Score = %f)",pokemon2->data->name, strength2);
+    float strength1 = pokemonCalcStregth(pokemon1);
+    float strength2 = pokemonCalcStregth(pokemon2);
+    printf("Pokemon 1: %s (Score = %f)",pokemon1->name, strength1);
+    printf("Pokemon 2: %s (Score = %f)",pokemon2->name, strength2);
     if (strength1 > strength2) {
-        printf("%s wins!", pokemon1->data->name);
+        printf("%s wins!", pokemon1->name);
     } else if(strength1 < strength2) {
-        printf("%s wins!", pokemon2->data->name);
+        printf("%s wins!", pokemon2->name);
     }
     else {
         printf("It’s a tie!");
@@ -759,15 +1379,13 @@ void evolvePokemon(OwnerNode *owner) {
         printf("Pokedex is empty.");
     }
 
-    int choice = readIntSafe("Enter ID of Pokemon to evolve: ");
-    PokemonNode *pokemon = searchPokemonBFS(owner->pokedexRoot, choice);
-    if (!pokemon) {
+    int choice = readSpeciesSafe("Enter ID of Pokemon to evolve: ");
+    int result = evolvePokemonByID(owner, choice);
+    if (result == 0) {
 	printf("No Pokemon with ID %d found.\n", choice);
         return;
     }
-    if (pokemon->data->CAN_EVOLVE) {
-        owner->pokedexRoot = removeNodeBST(owner->pokedexRoot, choice);
-        owner->pokedexRoot = insertPokemonNode(owner->pokedexRoot, createPokemonNode(&pokedex[choice]));
+    if (result == 1) {
         printf("Pokemon evolved from %s (ID %d) to %s (ID %d).\n",
 	            pokedex[choice - 1].name, choice,
 	            pokedex[choice].name, choice + 1);
@@ -775,502 +1393,6928 @@ void evolvePokemon(OwnerNode *owner) {
 }
 
 /**
- * @brief Prompt for an ID, BFS-check duplicates, then insert into BST.
+ * @brief Evolve one Pokemon (ID -> ID+1) without any prompting.
  * @param owner pointer to the Owner
- * Why we made it: Primary user function for adding new Pokemon to an owner’s Pokedex.
+ * @param id ID to evolve
+ * @return 1 if evolved, 0 if the owner doesn't have it, -1 if it can't evolve
  */
-void addPokemon(OwnerNode *owner) {
-    if (!owner)
-        return;
+int evolvePokemonByID(OwnerNode *owner, int id) {
 
-    int choice = readIntSafe("Enter ID to add: ");
-    if (choice < 1 && choice > 151)
-        return;
-    PokemonNode *pokemon = searchPokemonBFS(owner->pokedexRoot, choice);
-    if (pokemon)
-        return;
-    owner->pokedexRoot = insertPokemonNode(owner->pokedexRoot, createPokemonNode(&pokedex[choice - 1]));
+    const PokemonData *pokemon = ownerFindPokemon(owner, id);
+    if (!pokemon)
+        return 0;
+    if (!pokemon->CAN_EVOLVE || id >= POKEDEX_SIZE)
+        return -1;
+
+    thawFrozenPokedex(owner);
+    owner->pokedexRoot = removeNodeBST(owner->pokedexRoot, id);
+    owner->pokedexRoot = insertPokemonNode(owner->pokedexRoot, createPokemonNode(&pokedex[id]));
+    engineCopyRemove(owner, id);
+    engineCopyInsert(owner, &pokedex[id]);
+    return 1;
 }
 
-/**
- * @brief Prompt for ID, remove that Pokemon from BST by ID.
- * @param owner pointer to the Owner
- * Why we made it: Another user function for releasing a Pokemon.
- */
-void freePokemon(OwnerNode *owner) {
+// Final evolution stage for every species ID (index 0 unused), filled by initSpeciesTables()
+static int finalEvolutionID[POKEDEX_SIZE + 1];
 
-    if (!owner->pokedexRoot) {
-        printf("No Pokemon to release.\n");
-    }
+// pokedex[] indices ordered by name (case-insensitive), filled by initSpeciesTables()
+static unsigned short speciesByName[POKEDEX_SIZE];
 
-    int choice = readIntSafe("Enter Pokemon ID to release: ");
+// strcasecmp is not C99, and we don't want to allocate lowered copies per lookup
+static int compareNamesNoCase(const char *a, const char *b) {
 
-    owner->pokedexRoot = removePokemonByID(owner->pokedexRoot, choice);
+    while (*a && tolower((unsigned char)*a) == tolower((unsigned char)*b)) {
+        a++;
+        b++;
+    }
+    return tolower((unsigned char)*a) - tolower((unsigned char)*b);
 }
 
-/* ------------------------------------------------------------
-   7) Display Menu for a Pokedex
-   ------------------------------------------------------------ */
+/*
+ * Prefix trie over the lowercased species names, packed into one static array.
+ * Children are first-child/next-sibling indices (0 = none, node 0 is the root), and
+ * because names are inserted in speciesByName order every subtree covers a contiguous
+ * range [rangeLo, rangeHi) of speciesByName, so a prefix query never walks the subtree.
+ */
+#define SPECIES_TRIE_MAX_NODES 2048
+#define SPECIES_NAME_MAX 32
 
-/* ------------------------------------------------------------
-   8) Sorting Owners (Bubble Sort on Circular List)
-   ------------------------------------------------------------ */
+typedef struct {
+    char ch;
+    unsigned short firstChild;
+    unsigned short nextSibling;
+    unsigned short speciesId;
+    unsigned short rangeLo;
+    unsigned short rangeHi;
+} SpeciesTrieNode;
+
+static SpeciesTrieNode speciesTrie[SPECIES_TRIE_MAX_NODES];
+static int speciesTrieSize;
+
+static int trieFindChild(int node, char ch) {
+
+    int child = speciesTrie[node].firstChild;
+    while (child && speciesTrie[child].ch != ch)
+        child = speciesTrie[child].nextSibling;
+    return child;
+}
+
+static void trieInsertName(int nameRank) {
+
+    const PokemonData *data = &pokedex[speciesByName[nameRank]];
+    int node = 0;
+    speciesTrie[0].rangeHi = (unsigned short)(nameRank + 1);
+
+    for (const char *p = data->name; *p; p++) {
+        char ch = (char)tolower((unsigned char)*p);
+        int child = trieFindChild(node, ch);
+        if (!child) {
+            if (speciesTrieSize == SPECIES_TRIE_MAX_NODES)
+                return;
+            child = speciesTrieSize++;
+            speciesTrie[child].ch = ch;
+            speciesTrie[child].rangeLo = (unsigned short)nameRank;
+
+            // Names arrive sorted, so a new child always goes after its siblings
+            int last = speciesTrie[node].firstChild;
+            if (!last) {
+                speciesTrie[node].firstChild = (unsigned short)child;
+            } else {
+                while (speciesTrie[last].nextSibling)
+                    last = speciesTrie[last].nextSibling;
+                speciesTrie[last].nextSibling = (unsigned short)child;
+            }
+        }
+        speciesTrie[child].rangeHi = (unsigned short)(nameRank + 1);
+        node = child;
+    }
+    speciesTrie[node].speciesId = (unsigned short)data->id;
+}
 
 /**
- * @brief Sort the circular owners list by name.
- * Why we made it: Another demonstration of pointer manipulation + sorting logic.
+ * @brief List species whose names start with a prefix, ignoring case.
+ * @param prefix prefix like "char"
+ * @param outIds receives matching IDs in alphabetical order
+ * @param maxOut capacity of outIds
+ * @return total number of matches (may exceed maxOut)
+ * Why we made it: Autocomplete over the species names via the startup-built trie.
  */
-void sortOwners(void) {
+int searchSpeciesByPrefix(const char *prefix, int *outIds, int maxOut) {
 
-    if (ownerHead == NULL || ownerHead->next == ownerHead) {
-        return;  // List is empty or has only one node
-    }
+    if (prefix == NULL)
+        return 0;
 
-    int swapped;
-    OwnerNode *cur;
-    OwnerNode *last = ownerHead->prev;  // Last node in the circular list
+    int node = 0;
+    for (const char *p = prefix; *p; p++) {
+        node = trieFindChild(node, (char)tolower((unsigned char)*p));
+        if (!node)
+            return 0;
+    }
 
-    do {
-        swapped = 0;
-        cur = ownerHead;
+    int total = speciesTrie[node].rangeHi - speciesTrie[node].rangeLo;
+    for (int i = 0; i < total && i < maxOut; i++)
+        outIds[i] = pokedex[speciesByName[speciesTrie[node].rangeLo + i]].id;
+    return total;
+}
 
-        while (cur != last) {
-            if (strcmp(cur->ownerName, cur->next->ownerName) > 0) {
-                swapOwnerData(cur, cur->next);
-                swapped = 1;
-            }
-            cur = cur->next;
-        }
+typedef struct {
+    const char *query;
+    int queryLen;
+    int maxDistance;
+    int *outIds;
+    int maxOut;
+    int found;
+    int rows[SPECIES_NAME_MAX + 1][SPECIES_NAME_MAX + 1];
+} FuzzySearch;
+
+// Fill the Levenshtein row for `node` (at trie depth `depth`) from its parent's row, then recurse
+static void fuzzyVisit(FuzzySearch *fs, int node, int depth) {
+
+    const int *above = fs->rows[depth - 1];
+    int *row = fs->rows[depth];
+    int best = row[0] = depth;
+
+    for (int i = 1; i <= fs->queryLen; i++) {
+        int cost = (tolower((unsigned char)fs->query[i - 1]) == speciesTrie[node].ch) ? 0 : 1;
+        int value = above[i - 1] + cost;
+        if (above[i] + 1 < value)
+            value = above[i] + 1;
+        if (row[i - 1] + 1 < value)
+            value = row[i - 1] + 1;
+        row[i] = value;
+        if (value < best)
+            best = value;
+    }
 
-        // Move last one step back
-        last = last->prev;
+    if (speciesTrie[node].speciesId && row[fs->queryLen] <= fs->maxDistance) {
+        if (fs->found < fs->maxOut)
+            fs->outIds[fs->found] = speciesTrie[node].speciesId;
+        fs->found++;
+    }
 
-    } while (swapped);
+    // No deeper name can get closer than the best cell of this row
+    if (best > fs->maxDistance || depth == SPECIES_NAME_MAX)
+        return;
+    for (int child = speciesTrie[node].firstChild; child; child = speciesTrie[child].nextSibling)
+        fuzzyVisit(fs, child, depth + 1);
 }
 
 /**
- * @brief Helper to swap name & pokedexRoot in two OwnerNode.
- * @param a pointer to first owner
- * @param b pointer to second owner
- * Why we made it: Used internally by bubble sort to swap data.
+ * @brief List species within a bounded edit distance of a (possibly misspelled) name.
+ * @param query name as typed by the user
+ * @param maxDistance largest Levenshtein distance accepted
+ * @param outIds receives matching IDs in alphabetical order
+ * @param maxOut capacity of outIds
+ * @return total number of matches (may exceed maxOut)
+ * Why we made it: "Pikachoo" should still find Pikachu.
  */
-void swapOwnerData(OwnerNode *a, OwnerNode *b) {
+int fuzzySearchSpecies(const char *query, int maxDistance, int *outIds, int maxOut) {
+
+    if (query == NULL || maxDistance < 0)
+        return 0;
 
-    char *name = a->ownerName;
-    PokemonNode *root = a->pokedexRoot;
-    a->ownerName = b->ownerName;
-    a->pokedexRoot = b->pokedexRoot;
-    b->ownerName = name;
-    b->pokedexRoot = root;
+    FuzzySearch fs;
+    fs.query = query;
+    fs.queryLen = (int)strlen(query);
+    if (fs.queryLen > SPECIES_NAME_MAX)
+        return 0;
+    fs.maxDistance = maxDistance;
+    fs.outIds = outIds;
+    fs.maxOut = maxOut;
+    fs.found = 0;
+    for (int i = 0; i <= fs.queryLen; i++)
+        fs.rows[0][i] = i;
+
+    for (int child = speciesTrie[0].firstChild; child; child = speciesTrie[child].nextSibling)
+        fuzzyVisit(&fs, child, 1);
+    return fs.found;
 }
 
-/* ------------------------------------------------------------
-   9) Circular List Linking & Searching
-   ------------------------------------------------------------ */
+static int compareSpeciesIndexByName(const void *a, const void *b) {
+
+    const unsigned short *indexA = a;
+    const unsigned short *indexB = b;
+    return compareNamesNoCase(pokedex[*indexA].name, pokedex[*indexB].name);
+}
+
+// Same order compareByNameNode produces, so the alphabetical display doesn't change
+static int compareSpeciesIndexByExactName(const void *a, const void *b) {
+
+    const unsigned short *indexA = a;
+    const unsigned short *indexB = b;
+    return strcmp(pokedex[*indexA].name, pokedex[*indexB].name);
+}
 
 /**
- * @brief Insert a new owner into the circular list. If none exist, it's alone.
- * @param newOwner pointer to newly created OwnerNode
- * Why we made it: We need a standard approach to keep the list circular.
+ * @brief Look up a species ID by name, ignoring case.
+ * @param name species name like "charmander"
+ * @return matching ID, or 0 if no species has that name
+ * Why we made it: Binary search over a name-sorted index instead of strcmp over all of pokedex[].
  */
-void linkOwnerInCircularList(OwnerNode *newOwner) {
+int findSpeciesByName(const char *name) {
 
-    if (ownerHead == NULL) {
-        ownerHead = newOwner;
-    } else {
-        OwnerNode* last = ownerHead->prev;
-        newOwner->next = ownerHead;
-        newOwner->prev = last;
-        last->next = newOwner;
-        ownerHead->prev = newOwner;
+    if (name == NULL)
+        return 0;
+
+    int lo = 0;
+    int hi = POKEDEX_SIZE - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        const PokemonData *data = &pokedex[speciesByName[mid]];
+        int cmp = compareNamesNoCase(name, data->name);
+        if (cmp == 0)
+            return data->id;
+        if (cmp < 0)
+            hi = mid - 1;
+        else
+            lo = mid + 1;
     }
+    return 0;
 }
 
 /**
- * @brief Remove a specific OwnerNode from the circular list, possibly updating head.
- * @param target pointer to the OwnerNode
- * Why we made it: Deleting or merging owners requires removing them from the ring.
+ * @brief Precompute the per-species lookup tables derived from pokedex[].
+ * Why we made it: Species data is static, so we derive tables like the evolution chain once at startup.
  */
-void removeOwnerFromCircularList(OwnerNode *target) {
+void initSpeciesTables(void) {
 
-    if (target == NULL || ownerHead == NULL) {
-        return;
+    // Walk backwards so an evolving species can reuse the answer already stored for ID+1
+    for (int id = POKEDEX_SIZE; id >= 1; id--) {
+        if (pokedex[id - 1].CAN_EVOLVE == CAN_EVOLVE && id < POKEDEX_SIZE)
+            finalEvolutionID[id] = finalEvolutionID[id + 1];
+        else
+            finalEvolutionID[id] = id;
     }
-    if (target->next == target) {
-        ownerHead = NULL;
-    } else {
-        target->prev->next = target->next;
-        target->next->prev = target->prev;
 
-        // If the node to unlink is the head, update the head
-        if (target == ownerHead) {
-            ownerHead = target->next;
-        }
-    }
-    target->next = NULL;
-    target->prev = NULL;
+    for (int i = 0; i < POKEDEX_SIZE; i++)
+        speciesByName[i] = (unsigned short)i;
+    qsort(speciesByName, POKEDEX_SIZE, sizeof(speciesByName[0]), compareSpeciesIndexByName);
+
+    unsigned short byExactName[POKEDEX_SIZE];
+    for (int i = 0; i < POKEDEX_SIZE; i++)
+        byExactName[i] = (unsigned short)i;
+    qsort(byExactName, POKEDEX_SIZE, sizeof(byExactName[0]), compareSpeciesIndexByExactName);
+    for (int rank = 0; rank < POKEDEX_SIZE; rank++)
+        speciesAlphaRank[pokedex[byExactName[rank]].id] = (unsigned short)rank;
+
+    memset(speciesTrie, 0, sizeof(speciesTrie));
+    speciesTrieSize = 1;
+    for (int i = 0; i < POKEDEX_SIZE; i++)
+        trieInsertName(i);
 }
 
 /**
- * @brief Find an owner by name in the circular list.
- * @param name string to match
- * @return pointer to the matching OwnerNode or NULL
- * Why we made it: We often need to locate an owner quickly.
+ * @brief Final stage of the evolution chain that starts at the given ID.
+ * @param id species ID
+ * @return ID reached by evolving repeatedly (id itself if it cannot evolve)
+ * Why we made it: Evolve-to-final-form needs the last stage without walking the chain each time.
  */
-OwnerNode *findOwnerByName(const char *name) {
-
-    if (ownerHead == NULL || name == NULL) {
-        return NULL;
-    }
+int getFinalEvolutionID(int id) {
 
-    OwnerNode *cur = ownerHead;
-    do {
-        if (strcmp(cur->ownerName, name) == 0) {
-            return cur;
-    }
-        cur = cur->next;
-    } while (cur->next != ownerHead);
-    return NULL;
+    if (id < 1 || id > POKEDEX_SIZE)
+        return id;
+    return finalEvolutionID[id];
 }
 
+/**
+ * @brief Evolve every eligible node of a BST in one in-order pass.
+ * @param root BST root
+ * @param toFinalForm 0 = evolve one step (ID -> ID+1), 1 = jump to the final stage
+ * @return updated BST root
+ * Why we made it: Evolution never breaks ID order, so collisions are merged in one sorted pass.
+ */
+PokemonNode *evolveAllNodes(PokemonNode *root, int toFinalForm, FILE *out) {
 
+    int count = countPokemonNodes(root);
+    if (count == 0 || !unsharePokemonTree(&root))
+        return root;
 
-int printAndCountOwners(void) {
-    if (ownerHead == NULL) {
-        return 0;
+    NodeArray na;
+    na.nodes = NULL;
+    initNodeArray(&na, count);
+    if (!na.nodes)
+        return root;
+    collectAll(root, &na);
+
+    // In-order gives ascending IDs, and evolving maps a < b to evolved(a) <= evolved(b),
+    // so updating in place keeps the BST valid and any collision is with the previous survivor.
+    int kept = 0;
+    for (int i = 0; i < na.size; i++) {
+        PokemonNode *node = na.nodes[i];
+        int id = node->data->id;
+        int target = id;
+        if (toFinalForm)
+            target = getFinalEvolutionID(id);
+        else if (node->data->CAN_EVOLVE == CAN_EVOLVE && id < POKEDEX_SIZE)
+            target = id + 1;
+
+        if (target != id) {
+            node->data = &pokedex[target - 1];
+            if (out)
+                fprintf(out, "Pokemon evolved from %s (ID %d) to %s (ID %d).\n",
+                        pokedex[id - 1].name, id, pokedex[target - 1].name, target);
+        }
+
+        if (kept > 0 && na.nodes[kept - 1]->data->id == target) {
+            freePokemonNode(node);
+            continue;
+        }
+        na.nodes[kept++] = node;
     }
 
-    OwnerNode *cur = ownerHead;
-    int cnt = 1;
-    do {
-        printf("%d. %s\n", cnt, cur->ownerName);
-        cnt++;
-        cur = cur->next;
-    } while (cur != ownerHead);
-    return cnt - 1;
+    // Only relink when duplicates were dropped; otherwise the tree shape is untouched
+    if (kept != na.size)
+        root = buildBalancedTree(na.nodes, kept);
+
+    destroyNodeArray(&na);
+    return root;
 }
 
-OwnerNode *findOwnerByNum(int choice) {
+/**
+ * @brief Evolve every Pokemon in the owner's Pokedex by one step.
+ * @param owner pointer to the Owner
+ * Why we made it: Saves a menu round-trip per Pokemon when evolving a whole collection.
+ */
+void evolveAllPokemon(OwnerNode *owner) {
 
-    OwnerNode *cur = ownerHead;
-    int cnt = 1;
-    while (cnt++ < choice) {
-        cur = cur->next;
+    if (!owner)
+        return;
+
+    if (owner->pokedexRoot == NULL) {
+        printf("Pokedex is empty.\n");
+        return;
     }
-    return cur;
 
+    evolveOwnerPokedex(owner, 0, stdout);
 }
 
+/**
+ * @brief Evolve an owner's whole Pokedex, keeping an undo snapshot.
+ * @param owner pointer to the Owner
+ * @param toFinalForm 0 = one step, 1 = final stage
+ * @param out where to report each evolution (NULL = silently)
+ */
+void evolveOwnerPokedex(OwnerNode *owner, int toFinalForm, FILE *out) {
 
-
-/* ------------------------------------------------------------
-   10) Owner Menus
-   ------------------------------------------------------------ */
+    // snapshotPokedex takes the engine copy along
+    thawFrozenPokedex(owner);
+    compactPokedex(owner);
+    snapshotPokedex(owner);
+    owner->pokedexRoot = evolveAllNodes(owner->pokedexRoot, toFinalForm, out);
+}
 
 /**
- * @brief Creates a new Pokedex (prompt for name, check uniqueness, choose starter).
- * Why we made it: The main entry for building a brand-new Pokedex.
+ * @brief Evolve every Pokemon in the owner's Pokedex to its final form.
+ * @param owner pointer to the Owner
+ * Why we made it: Walks each Pokemon straight to the end of its evolution chain.
  */
-void openPokedexMenu(void) {
+void evolveToFinalForm(OwnerNode *owner) {
 
-    printf("Your name: ");
-    char *ownerName = getDynamicInput();
-    if (findOwnerByName(ownerName)) {
-	printf("Owner '%s' already exists. Not creating a new Pokedex.\n", ownerName);
-	free(ownerName);
-	return;
+    if (!owner)
+        return;
+
+    if (owner->pokedexRoot == NULL) {
+        printf("Pokedex is empty.\n");
+        return;
     }
-    int starter = readIntSafe("Choose Starter:\n1. Bulbasaur\n2. Charmander\n3. Squirtle\n");
-    const PokemonData *data =  &pokedex[3 * (starter - 1)];
-    OwnerNode* newOwner = createOwner(ownerName, createPokemonNode(data));
-    linkOwnerInCircularList(newOwner);
-    printf("New Pokedex created for %s with starter %s.\n", ownerName, data->name);
+
+    evolveOwnerPokedex(owner, 1, stdout);
 }
 
 /**
- * @brief Delete an entire Pokedex (owner) from the list.
- * Why we made it: Let user pick which Pokedex to remove and free everything.
+ * @brief Prompt for an ID, BFS-check duplicates, then insert into BST.
+ * @param owner pointer to the Owner
+ * Why we made it: Primary user function for adding new Pokemon to an owner’s Pokedex.
  */
-void deletePokedex(void) {
-
-    printf("=== Delete a Pokedex ===\n");
-    int cnt = printAndCountOwners();
-    int choice = readIntSafe("Choose a Pokedex to delete by number: ");
-    if (choice > cnt)
-        return;
-    OwnerNode *owner = findOwnerByNum(choice);
+void addPokemon(OwnerNode *owner) {
     if (!owner)
         return;
-    printf("Deleting %s's entire Pokedex...\n", owner->ownerName);
-    freePokemonTree(owner->pokedexRoot);
-    owner->pokedexRoot = NULL;
-    printf("Pokedex deleted.\n");
+
+    int choice = readSpeciesSafe("Enter ID to add: ");
+    addPokemonByID(owner, choice);
 }
 
-PokemonNode *mergePokedex(PokemonNode *pokedexIn, PokemonNode *pokedexOut) {
+/**
+ * @brief Add one Pokemon by ID without any prompting.
+ * @param owner pointer to the Owner
+ * @param id ID to add
+ * @return 1 if added, 0 if already there or out of range, -1 if out of memory
+ */
+int addPokemonByID(OwnerNode *owner, int id) {
 
-    if (pokedexOut == NULL)
-        return NULL;
+    if (id < 1 || id > POKEDEX_SIZE)
+        return 0;
+    if (ownerFindPokemon(owner, id))
+        return 0;
+    PokemonNode *node = createPokemonNode(&pokedex[id - 1]);
+    if (!node)
+        return -1;
+    thawFrozenPokedex(owner);
+    owner->pokedexRoot = insertPokemonNode(owner->pokedexRoot, node);
+    engineCopyInsert(owner, &pokedex[id - 1]);
+    return 1;
+}
 
-    Queue* q = createQueue();
-    enqueue(q, pokedexOut);
+/**
+ * @brief Merge a list of species IDs into a BST in one linear pass.
+ * @param root BST root
+ * @param ids species IDs in any order (duplicates and out-of-range IDs allowed)
+ * @param count number of IDs
+ * @param added out: number of species actually added (may be NULL)
+ * @return root of the resulting balanced BST
+ * Why we made it: Adding dozens of species one insert at a time costs a BFS + insert each.
+ */
+PokemonNode *bulkInsertPokemonIDs(PokemonNode *root, const int *ids, int count, int *added) {
 
-    while (q->front != NULL) {
-        PokemonNode* current = dequeue(q);
+    if (added)
+        *added = 0;
 
-        // Call the visit function on the current node
-        pokedexIn = insertPokemonNode(pokedexIn, createPokemonNode(current->data));
+    // IDs are bounded by the pokedex, so a presence table sorts and dedupes in one pass
+    char wanted[POKEDEX_SIZE + 1];
+    memset(wanted, 0, sizeof(wanted));
+    int distinct = 0;
+    for (int i = 0; i < count; i++) {
+        if (ids[i] < 1 || ids[i] > POKEDEX_SIZE || wanted[ids[i]])
+            continue;
+        wanted[ids[i]] = 1;
+        distinct++;
+    }
+    if (distinct == 0 || !unsharePokemonTree(&root))
+        return root;
 
-        if (current->left)
-            enqueue(q, current->left);
-        if (current->right)
-            enqueue(q, current->right);
+    int existing = countPokemonNodes(root);
+    NodeArray old;
+    NodeArray merged;
+    old.nodes = NULL;
+    merged.nodes = NULL;
+    if (existing > 0) {
+        initNodeArray(&old, existing);
+        if (!old.nodes)
+            return root;
+        collectAll(root, &old);
+    } else {
+        old.size = 0;
+    }
+    initNodeArray(&merged, existing + distinct);
+    if (!merged.nodes) {
+        if (old.nodes)
+            destroyNodeArray(&old);
+        return root;
     }
 
-    free(q);
+    // Merge the sorted existing nodes with the ascending wanted IDs
+    int i = 0;
+    int newCount = 0;
+    for (int id = 1; id <= POKEDEX_SIZE; id++) {
+        while (i < old.size && old.nodes[i]->data->id < id)
+            addNode(&merged, old.nodes[i++]);
+        if (!wanted[id])
+            continue;
+        if (i < old.size && old.nodes[i]->data->id == id)
+            continue;
+        PokemonNode *node = createPokemonNode(&pokedex[id - 1]);
+        if (!node)
+            continue;
+        addNode(&merged, node);
+        newCount++;
+    }
+    while (i < old.size)
+        addNode(&merged, old.nodes[i++]);
 
-    return pokedexIn;
+    root = buildBalancedTree(merged.nodes, merged.size);
 
+    if (old.nodes)
+        destroyNodeArray(&old);
+    destroyNodeArray(&merged);
+    if (added)
+        *added = newCount;
+    return root;
 }
 
-
 /**
- * @brief Merge the second owner's Pokedex into the first, then remove the second owner.
- * Why we made it: BFS copy demonstration plus removing an owner.
+ * @brief Prompt for a list of IDs on one line and add them all at once.
+ * @param owner pointer to the Owner
+ * Why we made it: Onboarding hands out many species at once; one prompt beats dozens.
  */
-void mergePokedexMenu(void) {
+void bulkAddPokemon(OwnerNode *owner) {
 
-    printf("=== Merge a Pokedex menu ===\n");
-    printf("Enter name of first owner: ");
-    char* nameIn = getDynamicInput();
-    printf("Enter name of second owner: ");
-    char* nameOut = getDynamicInput();
-    OwnerNode *ownerIn = findOwnerByName(nameIn);
-    OwnerNode *ownerOut = findOwnerByName(nameOut);
-    if (ownerIn == NULL || ownerOut == NULL) {
-        printf("Cannot find owners\n");
-	return;
+    if (!owner)
+        return;
+
+    printf("Enter IDs to add (separated by spaces or commas): ");
+    char *line = getDynamicInput();
+    if (!line)
+        return;
+
+    // Every ID takes at least one digit plus a separator
+    int *ids = malloc((strlen(line) / 2 + 1) * sizeof(int));
+    if (!ids) {
+        free(line);
+        return;
     }
-    printf("Merging %s and %s...\n", nameIn, nameOut);
 
-    ownerIn->pokedexRoot = mergePokedex(ownerIn->pokedexRoot, ownerOut->pokedexRoot);
-    printf("Merge completed.\n");
-    removeOwnerFromCircularList(ownerOut);
-    freeOwnerNode(ownerOut);
-    printf("Owner '%s' has been removed after merging\n", nameOut);
-    free(nameIn);
-    free(nameOut);
+    int count = 0;
+    char *cur = line;
+    while (*cur) {
+        if (*cur == ' ' || *cur == ',' || *cur == '\t') {
+            cur++;
+            continue;
+        }
+        char *endptr;
+        long value = strtol(cur, &endptr, 10);
+        if (endptr == cur || (*endptr && *endptr != ' ' && *endptr != ',' && *endptr != '\t')) {
+            // Skip the whole malformed token
+            while (*cur && *cur != ' ' && *cur != ',' && *cur != '\t')
+                cur++;
+            printf("Invalid input.\n");
+            continue;
+        }
+        if (value < 1 || value > POKEDEX_SIZE)
+            printf("Invalid ID %ld skipped.\n", value);
+        else
+            ids[count++] = (int)value;
+        cur = endptr;
+    }
 
+    printf("Added %d Pokemon.\n", bulkAddToOwner(owner, ids, count));
+
+    free(ids);
+    free(line);
 }
 
-/* ------------------------------------------------------------
-   11) Printing Owners in a Circle
-   ------------------------------------------------------------ */
+/**
+ * @brief Add many Pokemon by ID at once, keeping an undo snapshot.
+ * @param owner pointer to the Owner
+ * @param ids species IDs in any order
+ * @param count number of IDs
+ * @return number of species actually added
+ */
+int bulkAddToOwner(OwnerNode *owner, const int *ids, int count) {
+
+    int added = 0;
+    // snapshotPokedex takes the engine copy along
+    thawFrozenPokedex(owner);
+    compactPokedex(owner);
+    snapshotPokedex(owner);
+    owner->pokedexRoot = bulkInsertPokemonIDs(owner->pokedexRoot, ids, count, &added);
+    return added;
+}
 
 /**
- * @brief Print owners left or right from head, repeating as many times as user wants.
- * Why we made it: Demonstrates stepping through a circular list in a chosen direction.
+ * @brief Prompt for a name or prefix and show the owner's matching Pokemon.
+ * @param owner pointer to the Owner
+ * Why we made it: Prefix search first, fuzzy search as a fallback for typos.
  */
-void printOwnersCircular(void) {
+void searchPokemonByName(OwnerNode *owner) {
 
-    OwnerNode *cur = ownerHead;
-    if (!cur)
-		return;
+    if (!owner)
+        return;
 
-    printf("Enter direction (F or B): ");
-    char direct = '\0';
-    scanf("%c", &direct);
-    int count = readIntSafe("How many prints? ");
+    printf("Enter name or prefix: ");
+    char *query = getDynamicInput();
+    if (!query)
+        return;
+
+    int ids[POKEDEX_SIZE];
+    int total = searchSpeciesByPrefix(query, ids, POKEDEX_SIZE);
+    if (total == 0)
+        total = fuzzySearchSpecies(query, 2, ids, POKEDEX_SIZE);
+    if (total > POKEDEX_SIZE)
+        total = POKEDEX_SIZE;
+
+    // Keep only species the owner holds, one BST descent per candidate
+    int shown = 0;
+    for (int i = 0; i < total; i++) {
+        PokemonNode *node = searchPokemonBST(owner->pokedexRoot, ids[i]);
+        if (node) {
+            printPokemonNode(node);
+            shown++;
+        }
+    }
+    if (shown == 0)
+        printf("No matching Pokemon found.\n");
+
+    free(query);
+}
+
+/**
+ * @brief Prompt for ID, remove that Pokemon from BST by ID.
+ * @param owner pointer to the Owner
+ * Why we made it: Another user function for releasing a Pokemon.
+ */
+void freePokemon(OwnerNode *owner) {
+
+    if (!owner->pokedexRoot) {
+        printf("No Pokemon to release.\n");
+    }
+
+    int choice = readSpeciesSafe("Enter Pokemon ID to release: ");
+    releasePokemonByID(owner, choice);
+}
+
+/**
+ * @brief Release one Pokemon by ID without any prompting (lazily if the owner opted in).
+ * @param owner pointer to the Owner
+ * @param id ID to release
+ * @return 1 if released, 0 if the owner doesn't have it
+ */
+int releasePokemonByID(OwnerNode *owner, int id) {
+
+    if (!searchPokemonBST(owner->pokedexRoot, id))
+        return 0;
+    thawFrozenPokedex(owner);
+    if (owner->lazyRelease) {
+        if (!releasePokemonLazy(owner, id))
+            return 0;
+    } else {
+        owner->pokedexRoot = removeNodeBST(owner->pokedexRoot, id);
+    }
+    engineCopyRemove(owner, id);
+    return 1;
+}
+
+/* ------------------------------------------------------------
+   7) Display Menu for a Pokedex
+   ------------------------------------------------------------ */
+
+/* ------------------------------------------------------------
+   8) Sorting Owners (Per-Shard Sort + K-Way Merge)
+   ------------------------------------------------------------ */
+
+// Stable merge sort by name of a NULL-terminated list linked through next
+static OwnerNode *sortOwnerListByName(OwnerNode *list, size_t length) {
+
+    if (length < 2)
+        return list;
+
+    size_t half = length / 2;
+    OwnerNode *tail = list;
+    for (size_t i = 1; i < half; i++)
+        tail = tail->next;
+    OwnerNode *second = tail->next;
+    tail->next = NULL;
+
+    OwnerNode *a = sortOwnerListByName(list, half);
+    OwnerNode *b = sortOwnerListByName(second, length - half);
+    OwnerNode *head = NULL;
+    OwnerNode **link = &head;
+    while (a && b) {
+        if (strcmp(a->ownerName, b->ownerName) <= 0) {
+            *link = a;
+            a = a->next;
+        } else {
+            *link = b;
+            b = b->next;
+        }
+        link = &(*link)->next;
+    }
+    *link = a ? a : b;
+    return head;
+}
+
+/**
+ * @brief Renumber the owner listing in name order.
+ * Why we made it: Each shard sorts its own ring, then one merge pass across shards
+ * hands out the new listing ranks; no owner data moves between nodes.
+ */
+void sortOwners(void) {
+
+    if (ownerCount < 2) {
+        return;  // Nothing to reorder
+    }
+
+    for (int s = 0; s < OWNER_SHARDS; s++) {
+        OwnerShard *shard = &ownerShards[s];
+        if (shard->count < 2)
+            continue;
+
+        // Open the ring, sort it, then close it again with fresh prev links
+        shard->head->prev->next = NULL;
+        OwnerNode *head = sortOwnerListByName(shard->head, shard->count);
+        OwnerNode *last = head;
+        for (OwnerNode *cur = head->next; cur; cur = cur->next) {
+            cur->prev = last;
+            last = cur;
+        }
+        last->next = head;
+        head->prev = last;
+        shard->head = head;
+    }
+
+    // Every ring is in name order now, so the name-ordered merge is the new listing
+    OwnerCursor cursor;
+    ownerCursorStart(&cursor, OWNERS_BY_NAME);
+    unsigned long order = 1;
+    for (OwnerNode *cur = ownerCursorNext(&cursor); cur; cur = ownerCursorNext(&cursor))
+        cur->listOrder = order++;
+    nextListOrder = order;
+}
+
+/* ------------------------------------------------------------
+   9) Circular List Linking & Searching
+   ------------------------------------------------------------ */
+
+// Index bucket for a hash (its low bits already chose the shard)
+static size_t ownerBucket(const OwnerShard *shard, uint32_t hash) {
+
+    return (hash / OWNER_SHARDS) & (shard->bucketCount - 1);
+}
+
+// Grow a shard's index to at least minBuckets (by doubling) and rehash its ring;
+// 0 (old index kept) when out of memory
+static int growOwnerIndex(OwnerShard *shard, size_t minBuckets) {
+
+    size_t bucketCount = shard->bucketCount ? shard->bucketCount * 2 : 16;
+    while (bucketCount < minBuckets)
+        bucketCount *= 2;
+    OwnerNode **buckets = calloc(bucketCount, sizeof(OwnerNode *));
+    if (!buckets)
+        return 0;
+
+    free(shard->buckets);
+    shard->buckets = buckets;
+    shard->bucketCount = bucketCount;
+    OwnerNode *cur = shard->head;
+    for (size_t i = 0; i < shard->count; i++) {
+        size_t bucket = ownerBucket(shard, cur->nameHash);
+        cur->hashNext = buckets[bucket];
+        buckets[bucket] = cur;
+        cur = cur->next;
+    }
+    return 1;
+}
+
+// Ranks only grow, so appending keeps the shard ring in listing order. The caller
+// has already set nameHash and grown the index if it wanted to.
+static void appendOwnerToShard(OwnerShard *shard, OwnerNode *newOwner) {
+
+    newOwner->listOrder = nextListOrder++;
+    newOwner->hashNext = NULL;
+    if (shard->head == NULL) {
+        shard->head = newOwner;
+        newOwner->next = newOwner;
+        newOwner->prev = newOwner;
+    } else {
+        OwnerNode* last = shard->head->prev;
+        newOwner->next = shard->head;
+        newOwner->prev = last;
+        last->next = newOwner;
+        shard->head->prev = newOwner;
+    }
+    shard->count++;
+    ownerCount++;
+
+    if (shard->buckets) {
+        size_t bucket = ownerBucket(shard, newOwner->nameHash);
+        newOwner->hashNext = shard->buckets[bucket];
+        shard->buckets[bucket] = newOwner;
+    }
+}
+
+/**
+ * @brief Add a new owner to its shard's ring and name index, last in the listing.
+ * @param newOwner pointer to newly created OwnerNode
+ * Why we made it: We need a standard approach to keep the list circular.
+ */
+void linkOwnerInCircularList(OwnerNode *newOwner) {
+
+    newOwner->nameHash = ownerNameHash(newOwner->ownerName);
+    OwnerShard *shard = &ownerShards[newOwner->nameHash % OWNER_SHARDS];
+    if (shard->count >= shard->bucketCount)
+        growOwnerIndex(shard, shard->count + 1);
+    appendOwnerToShard(shard, newOwner);
+}
+
+/**
+ * @brief Add many new owners at once, last in the listing, in array order.
+ * @param owners newly created owners
+ * @param count number of owners
+ * Why we made it: Each shard's index is sized once for the whole batch instead of
+ * being rehashed every time it doubles.
+ */
+void linkOwnersBatch(OwnerNode **owners, size_t count) {
+
+    size_t incoming[OWNER_SHARDS] = {0};
+    for (size_t i = 0; i < count; i++) {
+        owners[i]->nameHash = ownerNameHash(owners[i]->ownerName);
+        incoming[owners[i]->nameHash % OWNER_SHARDS]++;
+    }
+    for (int i = 0; i < OWNER_SHARDS; i++) {
+        size_t total = ownerShards[i].count + incoming[i];
+        if (total > ownerShards[i].bucketCount)
+            growOwnerIndex(&ownerShards[i], total);
+    }
+    for (size_t i = 0; i < count; i++)
+        appendOwnerToShard(&ownerShards[owners[i]->nameHash % OWNER_SHARDS], owners[i]);
+}
+
+/**
+ * @brief Remove a specific OwnerNode from its shard's ring and name index.
+ * @param target pointer to the OwnerNode
+ * Why we made it: Deleting or merging owners requires removing them from the ring.
+ */
+void removeOwnerFromCircularList(OwnerNode *target) {
+
+    if (target == NULL || target->next == NULL) {
+        return;
+    }
+
+    OwnerShard *shard = &ownerShards[target->nameHash % OWNER_SHARDS];
+    if (shard->buckets) {
+        OwnerNode **link = &shard->buckets[ownerBucket(shard, target->nameHash)];
+        while (*link && *link != target)
+            link = &(*link)->hashNext;
+        if (*link)
+            *link = target->hashNext;
+    }
+
+    if (target->next == target) {
+        shard->head = NULL;
+    } else {
+        target->prev->next = target->next;
+        target->next->prev = target->prev;
+
+        // If the node to unlink is the head, update the head
+        if (target == shard->head) {
+            shard->head = target->next;
+        }
+    }
+    target->next = NULL;
+    target->prev = NULL;
+    target->hashNext = NULL;
+    shard->count--;
+    ownerCount--;
+}
+
+/**
+ * @brief Find an owner by name through its shard's index.
+ * @param name string to match
+ * @return pointer to the matching OwnerNode or NULL
+ * Why we made it: We often need to locate an owner quickly.
+ */
+OwnerNode *findOwnerByName(const char *name) {
+
+    if (name == NULL) {
+        return NULL;
+    }
+
+    uint32_t hash = ownerNameHash(name);
+    OwnerShard *shard = &ownerShards[hash % OWNER_SHARDS];
+    OwnerNode *cur;
+    if (shard->buckets) {
+        for (cur = shard->buckets[ownerBucket(shard, hash)]; cur; cur = cur->hashNext) {
+            if (cur->nameHash == hash && !__atomic_load_n(&cur->merged, __ATOMIC_ACQUIRE) &&
+                strcmp(cur->ownerName, name) == 0)
+                return cur;
+        }
+        return NULL;
+    }
+
+    // No index (it could not be allocated): scan this shard's ring
+    cur = shard->head;
+    for (size_t i = 0; i < shard->count; i++, cur = cur->next) {
+        if (!__atomic_load_n(&cur->merged, __ATOMIC_ACQUIRE) && strcmp(cur->ownerName, name) == 0)
+            return cur;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Lock two different owners in address order.
+ * @param a first owner
+ * @param b second owner
+ * Why we made it: Two merges naming the same pair in opposite order must not deadlock.
+ */
+void lockOwnerPair(OwnerNode *a, OwnerNode *b) {
+
+    if ((uintptr_t)a > (uintptr_t)b) {
+        OwnerNode *tmp = a;
+        a = b;
+        b = tmp;
+    }
+    pthread_mutex_lock(&a->lock);
+    pthread_mutex_lock(&b->lock);
+}
+
+static int compareOwnerAddress(const void *a, const void *b) {
+
+    uintptr_t x = (uintptr_t)*(OwnerNode *const *)a;
+    uintptr_t y = (uintptr_t)*(OwnerNode *const *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Lock a set of different owners in address order.
+ * @param owners owners to lock (reordered by address; unlock in any order)
+ * @param count number of owners
+ * Why we made it: Same deadlock rule as lockOwnerPair, for merges naming many owners.
+ */
+void lockOwnerSet(OwnerNode **owners, int count) {
+
+    qsort(owners, (size_t)count, sizeof(OwnerNode *), compareOwnerAddress);
+    for (int i = 0; i < count; i++)
+        pthread_mutex_lock(&owners[i]->lock);
+}
+
+
+
+int printAndCountOwners(void) {
+
+    OwnerCursor cursor;
+    ownerCursorStart(&cursor, OWNERS_FORWARD);
+    int cnt = 0;
+    for (OwnerNode *cur = ownerCursorNext(&cursor); cur; cur = ownerCursorNext(&cursor))
+        printf("%d. %s\n", ++cnt, cur->ownerName);
+    return cnt;
+}
+
+OwnerNode *findOwnerByNum(int choice) {
+
+    OwnerCursor cursor;
+    ownerCursorStart(&cursor, OWNERS_FORWARD);
+    OwnerNode *cur = ownerCursorNext(&cursor);
+    for (int cnt = 1; cur && cnt < choice; cnt++)
+        cur = ownerCursorNext(&cursor);
+    return cur;
+
+}
+
+
+
+/* ------------------------------------------------------------
+   10) Owner Menus
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Creates a new Pokedex (prompt for name, check uniqueness, choose starter).
+ * Why we made it: The main entry for building a brand-new Pokedex.
+ */
+void openPokedexMenu(void) {
+
+    printf("Your name: ");
+    char *ownerName = getDynamicInput();
+    if (findOwnerByName(ownerName)) {
+	printf("Owner '%s' already exists. Not creating a new Pokedex.\n", ownerName);
+	free(ownerName);
+	return;
+    }
+    int starter = readIntSafe("Choose Starter:\n1. Bulbasaur\n2. Charmander\n3. Squirtle\n");
+    const PokemonData *data =  &pokedex[3 * (starter - 1)];
+    PokemonNode *starterNode = createPokemonNode(data);
+    OwnerNode* newOwner = createOwner(ownerName, starterNode);
+    if (!newOwner) {
+        freePokemonTree(starterNode);
+        free(ownerName);
+        return;
+    }
+    linkOwnerInCircularList(newOwner);
+    printf("New Pokedex created for %s with starter %s.\n", newOwner->ownerName, data->name);
+}
+
+/**
+ * @brief Delete an entire Pokedex (owner) from the list.
+ * Why we made it: Let user pick which Pokedex to remove and free everything.
+ */
+void deletePokedex(void) {
+
+    printf("=== Delete a Pokedex ===\n");
+    int cnt = printAndCountOwners();
+    int choice = readIntSafe("Choose a Pokedex to delete by number: ");
+    if (choice > cnt)
+        return;
+    OwnerNode *owner = findOwnerByNum(choice);
+    if (!owner)
+        return;
+    printf("Deleting %s's entire Pokedex...\n", owner->ownerName);
+    clearOwnerPokedex(owner);
+    printf("Pokedex deleted.\n");
+}
+
+/**
+ * @brief Free every Pokemon an owner has; the owner itself stays.
+ * @param owner pointer to the Owner
+ */
+void clearOwnerPokedex(OwnerNode *owner) {
+
+    thawPokedex(owner);
+    freePokemonTree(owner->pokedexRoot);
+    owner->pokedexRoot = NULL;
+    owner->deadCount = 0;
+}
+
+static TraverseResult visitCopyInto(PokemonNode *node, void *ctx) {
+
+    PokemonNode **pokedexIn = ctx;
+    *pokedexIn = insertPokemonNode(*pokedexIn, createPokemonNode(node->data));
+    return TRAVERSE_CONTINUE;
+}
+
+PokemonNode *mergePokedex(PokemonNode *pokedexIn, PokemonNode *pokedexOut) {
+
+    if (pokedexOut == NULL)
+        return pokedexIn;
+
+    // Disjoint ID ranges share pokedexOut's nodes instead of copying them
+    if (joinPokemonTrees(&pokedexIn, pokedexOut) > 0)
+        return pokedexIn;
+
+    BFSGenericCtx(pokedexOut, visitCopyInto, &pokedexIn);
+    return pokedexIn;
+}
+
+
+/**
+ * @brief Merge ownerOut's Pokedex into ownerIn's, then unlink and free ownerOut.
+ * @param ownerIn owner that keeps the merged Pokedex
+ * @param ownerOut owner that is removed
+ */
+void mergeOwners(OwnerNode *ownerIn, OwnerNode *ownerOut) {
+
+    mergePokedexInto(ownerIn, ownerOut);
+    removeOwnerFromCircularList(ownerOut);
+    freeOwnerNode(ownerOut);
+}
+
+/**
+ * @brief Copy ownerOut's Pokedex into ownerIn's (keeping an undo snapshot); ownerOut is untouched.
+ * @param ownerIn owner that receives the Pokemon
+ * @param ownerOut owner whose Pokemon are copied
+ */
+void mergePokedexInto(OwnerNode *ownerIn, OwnerNode *ownerOut) {
+
+    // snapshotPokedex takes the engine copy along
+    thawFrozenPokedex(ownerIn);
+    compactPokedex(ownerIn);
+    snapshotPokedex(ownerIn);
+    ownerIn->pokedexRoot = mergePokedex(ownerIn->pokedexRoot, ownerOut->pokedexRoot);
+    // A join brings ownerOut's tombstones along (the count only has to over-estimate)
+    ownerIn->deadCount += ownerOut->deadCount;
+}
+
+/**
+ * @brief Merge the second owner's Pokedex into the first, then remove the second owner.
+ * Why we made it: BFS copy demonstration plus removing an owner.
+ */
+void mergePokedexMenu(void) {
+
+    printf("=== Merge a Pokedex menu ===\n");
+    printf("Enter name of first owner: ");
+    char* nameIn = getDynamicInput();
+    printf("Enter name of second owner: ");
+    char* nameOut = getDynamicInput();
+    OwnerNode *ownerIn = findOwnerByName(nameIn);
+    OwnerNode *ownerOut = findOwnerByName(nameOut);
+    if (ownerIn == NULL || ownerOut == NULL || ownerIn == ownerOut) {
+        printf("Cannot find owners\n");
+        free(nameIn);
+        free(nameOut);
+	return;
+    }
+    printf("Merging %s and %s...\n", nameIn, nameOut);
+
+    mergeOwners(ownerIn, ownerOut);
+    printf("Merge completed.\n");
+    printf("Owner '%s' has been removed after merging\n", nameOut);
+    free(nameIn);
+    free(nameOut);
+
+}
+
+/* ------------------------------------------------------------
+   11) Printing Owners in a Circle
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Print owners left or right from head, repeating as many times as user wants.
+ * Why we made it: Demonstrates stepping through a circular list in a chosen direction.
+ */
+void printOwnersCircular(void) {
+
+    if (ownerCount == 0)
+		return;
+
+    printf("Enter direction (F or B): ");
+    char direct = '\0';
+    scanf("%c", &direct);
+    int count = readIntSafe("How many prints? ");
+
+    OwnerWalk walk;
+    if (direct == 'F' || direct == 'f')
+        walk = OWNERS_FORWARD;
+    else if (direct == 'B' || direct == 'b')
+        walk = OWNERS_BACKWARD;
+    else
+        return;
+
+    // Both directions start at the first owner; going back from it wraps to the last
+    OwnerCursor cursor;
+    ownerCursorStart(&cursor, OWNERS_FORWARD);
+    OwnerNode *cur = ownerCursorNext(&cursor);
+    if (walk == OWNERS_BACKWARD)
+        ownerCursorStart(&cursor, OWNERS_BACKWARD);
+    for (int i = 1; i <= count; i++) {
+        printf("[%d] %s", i, cur->ownerName);
+        cur = ownerCursorNext(&cursor);
+        if (!cur) {
+            ownerCursorStart(&cursor, walk);
+            cur = ownerCursorNext(&cursor);
+        }
+    }
+}
+
+/* ------------------------------------------------------------
+   12) Cleanup All Owners at Program End
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Frees every remaining owner and empties every shard.
+ * Why we made it: Ensures a squeaky-clean exit with no leftover memory.
+ */
+void freeAllOwners(void) {
+
+#ifdef ARENA_DEBUG
+    for (int s = 0; s < OWNER_SHARDS; s++) {
+        OwnerNode *cur = ownerShards[s].head;
+        for (size_t i = 0; i < ownerShards[s].count; i++) {
+            OwnerNode *next = cur->next;
+            freeOwnerNode(cur);
+            cur = next;
+        }
+    }
+#else
+    // Owners, names, trees, snapshots and frozen copies all live in the arena; engine
+    // copies are malloc'd blocks of their own
+    for (int s = 0; s < OWNER_SHARDS; s++) {
+        OwnerNode *cur = ownerShards[s].head;
+        for (size_t i = 0; i < ownerShards[s].count; i++, cur = cur->next) {
+            dropEngineCopy(cur);
+            dropEngineSnapshot(cur);
+        }
+    }
+    if (ownerCount > 0)
+        arenaReset();
+#endif
+
+    for (int s = 0; s < OWNER_SHARDS; s++)
+        free(ownerShards[s].buckets);
+    memset(ownerShards, 0, sizeof(ownerShards));
+    ownerCount = 0;
+    nextListOrder = 1;
+}
+
+
+// --------------------------------------------------------------
+// Display Menu
+// --------------------------------------------------------------
+void displayMenu(OwnerNode *owner)
+{
+    if (!owner->pokedexRoot)
+    {
+        printf("Pokedex is empty.\n");
+        return;
+    }
+
+    printf("Display:\n");
+    printf("1. BFS (Level-Order)\n");
+    printf("2. Pre-Order\n");
+    printf("3. In-Order\n");
+    printf("4. Post-Order\n");
+    printf("5. Alphabetical (by name)\n");
+
+    int choice = readIntSafe("Your choice: ");
+
+    // With --engine the tree orders walk the owner's copy in that backend, in its own shape
+    void *copy = (choice >= 1 && choice <= 4) ? ownerEngineCopy(owner) : NULL;
+    if (copy) {
+        static const TraversalOrder orders[] = {ORDER_BFS, ORDER_PRE, ORDER_IN, ORDER_POST};
+        lookupEngine->traverse(copy, orders[choice - 1], printPokemonNode);
+        return;
+    }
+
+    switch (choice)
+    {
+    case 1:
+        displayBFS(owner->pokedexRoot);
+        break;
+    case 2:
+        preOrderTraversal(owner->pokedexRoot);
+        break;
+    case 3:
+        inOrderTraversal(owner->pokedexRoot);
+        break;
+    case 4:
+        postOrderTraversal(owner->pokedexRoot);
+        break;
+    case 5:
+        displayAlphabetical(owner->pokedexRoot);
+        break;
+    default:
+        printf("Invalid choice.\n");
+    }
+}
+
+// --------------------------------------------------------------
+// Sub-menu for existing Pokedex
+// --------------------------------------------------------------
+void enterExistingPokedexMenu(void)
+{
+    // list owners
+    printf("\nExisting Pokedexes:\n");
+
+    int cnt = printAndCountOwners();
+
+    int choice = readIntSafe("Choose a Pokedex by number:");
+    if (choice > cnt)
+        return;
+    OwnerNode *cur = findOwnerByNum(choice);
+    if (!cur)
+        return;
+
+    printf("\nEntering %s's Pokedex...\n", cur->ownerName);
+
+    int subChoice;
+    do
+    {
+        printf("\n-- %s's Pokedex Menu --\n", cur->ownerName);
+        printf("1. Add Pokemon\n");
+        printf("2. Display Pokedex\n");
+        printf("3. Release Pokemon (by ID)\n");
+        printf("4. Pokemon Fight!\n");
+        printf("5. Evolve Pokemon\n");
+        printf("6. Back to Main\n");
+        printf("7. Evolve All Pokemon\n");
+        printf("8. Evolve All to Final Form\n");
+        printf("9. Add Many Pokemon\n");
+        printf("10. Search Pokemon by Name\n");
+        printf("11. Freeze Pokedex (fast lookups)\n");
+        printf("12. Undo Last Bulk Change\n");
+        printf("13. Toggle Lazy Release\n");
+
+        subChoice = readIntSafe("Your choice: ");
+
+        switch (subChoice)
+        {
+        case 1:
+            addPokemon(cur);
+            break;
+        case 2:
+            displayMenu(cur);
+            break;
+        case 3:
+            freePokemon(cur);
+            break;
+        case 4:
+            pokemonFight(cur);
+            break;
+        case 5:
+            evolvePokemon(cur);
+            break;
+        case 6:
+            printf("Back to Main Menu.\n");
+            break;
+        case 7:
+            evolveAllPokemon(cur);
+            break;
+        case 8:
+            evolveToFinalForm(cur);
+            break;
+        case 9:
+            bulkAddPokemon(cur);
+            break;
+        case 10:
+            searchPokemonByName(cur);
+            break;
+        case 11:
+            freezePokedexMenu(cur);
+            break;
+        case 12:
+            restorePokedexSnapshot(cur);
+            break;
+        case 13:
+            toggleLazyRelease(cur);
+            break;
+        default:
+            printf("Invalid choice.\n");
+        }
+    } while (subChoice != 6);
+}
+
+// --------------------------------------------------------------
+// Main Menu
+// --------------------------------------------------------------
+void mainMenu()
+{
+    int choice;
+    do
+    {
+        printf("\n=== Main Menu ===\n");
+        printf("1. New Pokedex\n");
+        printf("2. Existing Pokedex\n");
+        printf("3. Delete a Pokedex\n");
+        printf("4. Merge Pokedexes\n");
+        printf("5. Sort Owners by Name\n");
+        printf("6. Print Owners in a direction X times\n");
+        printf("7. Exit\n");
+        printf("8. Clone a Pokedex\n");
+        printf("9. Merge Many Pokedexes\n");
+        printf("10. Pokedex Statistics\n");
+        printf("11. Export Pokedexes\n");
+        printf("12. Import Owners from CSV\n");
+        printf("13. Save Snapshot\n");
+        printf("14. Load Snapshot\n");
+        choice = readIntSafe("Your choice: ");
+
+        switch (choice)
+        {
+        case 1:
+            openPokedexMenu();
+            break;
+        case 2:
+            enterExistingPokedexMenu();
+            break;
+        case 3:
+            deletePokedex();
+            break;
+        case 4:
+            mergePokedexMenu();
+            break;
+        case 5:
+            sortOwners();
+            break;
+        case 6:
+            printOwnersCircular();
+            break;
+        case 7:
+            printf("Goodbye!\n");
+            break;
+        case 8:
+            cloneOwnerMenu();
+            break;
+        case 9:
+            mergeManyMenu();
+            break;
+        case 10:
+            pokedexStatsMenu();
+            break;
+        case 11:
+            exportOwnersMenu();
+            break;
+        case 12:
+            importOwnersMenu();
+            break;
+        case 13:
+            saveSnapshotMenu();
+            break;
+        case 14:
+            loadSnapshotMenu();
+            break;
+        default:
+            printf("Invalid.\n");
+        }
+    } while (choice != 7);
+}
+
+/* ------------------------------------------------------------
+   14) Compact Pokedex (Array-Indexed Tree)
+   ------------------------------------------------------------ */
+
+// Bytes per slot across the three parallel arrays
+#define COMPACT_SLOT_BYTES (2 * sizeof(uint32_t) + sizeof(uint16_t))
+#define COMPACT_MIN_CAPACITY 16
+
+// Point the three arrays into one block: left[], then right[], then species[]
+static void compactCarve(CompactPokedex *dex, unsigned char *block, uint32_t capacity) {
+
+    dex->left = (uint32_t *)block;
+    dex->right = (uint32_t *)(block + capacity * sizeof(uint32_t));
+    dex->species = (uint16_t *)(block + 2 * capacity * sizeof(uint32_t));
+    dex->capacity = capacity;
+}
+
+/**
+ * @brief Create an empty compact Pokedex.
+ * @param capacity initial number of slots (grows on demand)
+ * @return newly allocated CompactPokedex*, or NULL on failure
+ * Why we made it: An owner's tree in a few cache lines instead of scattered heap nodes.
+ */
+CompactPokedex *createCompactPokedex(uint32_t capacity) {
+
+    if (capacity < COMPACT_MIN_CAPACITY)
+        capacity = COMPACT_MIN_CAPACITY;
+
+    CompactPokedex *dex = malloc(sizeof(CompactPokedex));
+    if (!dex)
+        return NULL;
+    unsigned char *block = malloc(capacity * COMPACT_SLOT_BYTES);
+    if (!block) {
+        free(dex);
+        return NULL;
+    }
+    compactCarve(dex, block, capacity);
+    dex->used = 0;
+    dex->count = 0;
+    dex->root = COMPACT_NIL;
+    dex->freeHead = COMPACT_NIL;
+    return dex;
+}
+
+/**
+ * @brief Free a compact Pokedex and its slot block.
+ * @param dex pointer to the compact Pokedex (may be NULL)
+ */
+void freeCompactPokedex(CompactPokedex *dex) {
+
+    if (!dex)
+        return;
+    free(dex->left);  // left[] is the start of the block
+    free(dex);
+}
+
+static int compactGrow(CompactPokedex *dex) {
+
+    uint32_t capacity = dex->capacity * 2;
+    unsigned char *block = malloc(capacity * COMPACT_SLOT_BYTES);
+    if (!block)
+        return 0;
+
+    CompactPokedex grown = *dex;
+    compactCarve(&grown, block, capacity);
+    memcpy(grown.left, dex->left, dex->used * sizeof(uint32_t));
+    memcpy(grown.right, dex->right, dex->used * sizeof(uint32_t));
+    memcpy(grown.species, dex->species, dex->used * sizeof(uint16_t));
+    free(dex->left);
+    *dex = grown;
+    return 1;
+}
+
+static uint32_t compactAllocSlot(CompactPokedex *dex) {
+
+    uint32_t slot = dex->freeHead;
+    if (slot != COMPACT_NIL) {
+        dex->freeHead = dex->right[slot];
+        return slot;
+    }
+    if (dex->used == dex->capacity && !compactGrow(dex))
+        return COMPACT_NIL;
+    return dex->used++;
+}
+
+/**
+ * @brief Insert a species by ID; duplicates ignored (like insertPokemonNode).
+ * @param dex pointer to the compact Pokedex
+ * @param data species to insert (from the global pokedex)
+ * @return 1 if inserted, 0 if already present, -1 if out of memory
+ */
+int compactInsert(CompactPokedex *dex, const PokemonData *data) {
+
+    if (!dex || !data)
+        return -1;
+
+    int id = data->id;
+    uint32_t parent = COMPACT_NIL;
+    int goLeft = 0;
+    uint32_t slot = dex->root;
+    while (slot != COMPACT_NIL) {
+        int here = dex->species[slot];
+        if (id == here)
+            return 0;
+        parent = slot;
+        goLeft = (id < here);
+        slot = goLeft ? dex->left[slot] : dex->right[slot];
+    }
+
+    // Link by index, not by pointer: allocating a slot may move the arrays
+    slot = compactAllocSlot(dex);
+    if (slot == COMPACT_NIL)
+        return -1;
+    dex->left[slot] = COMPACT_NIL;
+    dex->right[slot] = COMPACT_NIL;
+    dex->species[slot] = (uint16_t)id;
+
+    if (parent == COMPACT_NIL)
+        dex->root = slot;
+    else if (goLeft)
+        dex->left[parent] = slot;
+    else
+        dex->right[parent] = slot;
+    dex->count++;
+    return 1;
+}
+
+/**
+ * @brief Remove a species by ID (like removeNodeBST); its slot goes on the free list.
+ * @param dex pointer to the compact Pokedex
+ * @param id ID to remove
+ * @return 1 if removed, 0 if not found
+ */
+int compactRemove(CompactPokedex *dex, int id) {
+
+    if (!dex)
+        return 0;
+
+    uint32_t *link = &dex->root;
+    while (*link != COMPACT_NIL && dex->species[*link] != id)
+        link = (id < dex->species[*link]) ? &dex->left[*link] : &dex->right[*link];
+    if (*link == COMPACT_NIL)
+        return 0;
+
+    uint32_t target = *link;
+    if (dex->left[target] != COMPACT_NIL && dex->right[target] != COMPACT_NIL) {
+        // Two children: take the successor's species, then unlink the successor instead
+        uint32_t *succLink = &dex->right[target];
+        while (dex->left[*succLink] != COMPACT_NIL)
+            succLink = &dex->left[*succLink];
+        uint32_t succ = *succLink;
+        dex->species[target] = dex->species[succ];
+        *succLink = dex->right[succ];
+        target = succ;
+    } else {
+        *link = (dex->left[target] != COMPACT_NIL) ? dex->left[target] : dex->right[target];
+    }
+
+    dex->species[target] = 0;
+    dex->left[target] = COMPACT_NIL;
+    dex->right[target] = dex->freeHead;
+    dex->freeHead = target;
+    dex->count--;
+    return 1;
+}
+
+/**
+ * @brief Find a species by ID by descending the tree.
+ * @param dex pointer to the compact Pokedex
+ * @param id ID to find
+ * @return species data, or NULL if not present
+ */
+const PokemonData *compactSearch(const CompactPokedex *dex, int id) {
+
+    if (!dex)
+        return NULL;
+
+    uint32_t slot = dex->root;
+    while (slot != COMPACT_NIL) {
+        int here = dex->species[slot];
+        if (id == here)
+            return &pokedex[here - 1];
+        slot = (id < here) ? dex->left[slot] : dex->right[slot];
+    }
+    return NULL;
+}
+
+// Hand a species to a VisitNodeFunc through a stack-local node view, so existing
+// visitors like printPokemonNode work on layouts that have no PokemonNode of their own
+static void visitSpeciesView(int id, VisitNodeFunc visit) {
+
+    PokemonNode view;
+    view.data = &pokedex[id - 1];
+    view.left = NULL;
+    view.right = NULL;
+    view.dead = 0;
+    view.refs = 1;
+    visit(&view);
+}
+
+static void compactVisitSlot(const CompactPokedex *dex, uint32_t slot, VisitNodeFunc visit) {
+
+    visitSpeciesView(dex->species[slot], visit);
+}
+
+/**
+ * @brief Walk the compact tree in the given order, calling visit() like the *Generic walkers.
+ * @param dex pointer to the compact Pokedex
+ * @param order BFS, pre-, in- or post-order
+ * @param visit receives a PokemonNode view of each slot (children are not filled in)
+ * Why we made it: Lets printPokemonNode and the other VisitNodeFuncs work unchanged.
+ */
+void compactTraverse(const CompactPokedex *dex, TraversalOrder order, VisitNodeFunc visit) {
+
+    if (!dex || dex->root == COMPACT_NIL)
+        return;
+
+    // Neither a BFS queue nor a DFS stack ever holds more than every live node
+    uint32_t *pending = malloc(dex->count * sizeof(uint32_t));
+    if (!pending)
+        return;
+
+    uint32_t size = 0;
+    uint32_t current = dex->root;
+    uint32_t lastVisited = COMPACT_NIL;
+
+    switch (order) {
+    case ORDER_BFS:
+        pending[size++] = dex->root;
+        for (uint32_t head = 0; head < size; head++) {
+            uint32_t slot = pending[head];
+            compactVisitSlot(dex, slot, visit);
+            if (dex->left[slot] != COMPACT_NIL)
+                pending[size++] = dex->left[slot];
+            if (dex->right[slot] != COMPACT_NIL)
+                pending[size++] = dex->right[slot];
+        }
+        break;
+    case ORDER_PRE:
+        pending[size++] = dex->root;
+        while (size > 0) {
+            uint32_t slot = pending[--size];
+            compactVisitSlot(dex, slot, visit);
+            if (dex->right[slot] != COMPACT_NIL)
+                pending[size++] = dex->right[slot];
+            if (dex->left[slot] != COMPACT_NIL)
+                pending[size++] = dex->left[slot];
+        }
+        break;
+    case ORDER_IN:
+        while (current != COMPACT_NIL || size > 0) {
+            while (current != COMPACT_NIL) {
+                pending[size++] = current;
+                current = dex->left[current];
+            }
+            current = pending[--size];
+            compactVisitSlot(dex, current, visit);
+            current = dex->right[current];
+        }
+        break;
+    case ORDER_POST:
+        while (current != COMPACT_NIL || size > 0) {
+            while (current != COMPACT_NIL) {
+                pending[size++] = current;
+                current = dex->left[current];
+            }
+            uint32_t top = pending[size - 1];
+            if (dex->right[top] != COMPACT_NIL && dex->right[top] != lastVisited) {
+                current = dex->right[top];
+            } else {
+                compactVisitSlot(dex, top, visit);
+                lastVisited = pending[--size];
+            }
+        }
+        break;
+    }
+
+    free(pending);
+}
+
+static TraverseResult visitCompactInsert(PokemonNode *node, void *ctx) {
+
+    return compactInsert(ctx, node->data) < 0 ? TRAVERSE_STOP : TRAVERSE_CONTINUE;
+}
+
+/**
+ * @brief Build a compact Pokedex with the same shape as a PokemonNode tree.
+ * @param root BST root
+ * @return newly allocated CompactPokedex*, or NULL on failure
+ */
+CompactPokedex *compactFromTree(PokemonNode *root) {
+
+    CompactPokedex *dex = createCompactPokedex((uint32_t)countPokemonNodes(root));
+    if (!dex)
+        return NULL;
+
+    // Inserting in level order reproduces the exact shape of the source tree
+    if (BFSGenericCtx(root, visitCompactInsert, dex) == TRAVERSE_STOP) {
+        freeCompactPokedex(dex);
+        return NULL;
+    }
+    return dex;
+}
+
+/**
+ * @brief Copy a compact Pokedex with a single memcpy of its slot block.
+ * @param dex pointer to the compact Pokedex
+ * @return independent copy, or NULL on failure
+ * Why we made it: Index-based links stay valid in a copy, so cloning an owner's compact
+ * Pokedex needs no pointer fix-up.
+ */
+CompactPokedex *compactSnapshot(const CompactPokedex *dex) {
+
+    if (!dex)
+        return NULL;
+
+    CompactPokedex *copy = malloc(sizeof(CompactPokedex));
+    if (!copy)
+        return NULL;
+    unsigned char *block = malloc(dex->capacity * COMPACT_SLOT_BYTES);
+    if (!block) {
+        free(copy);
+        return NULL;
+    }
+    memcpy(block, dex->left, dex->capacity * COMPACT_SLOT_BYTES);
+    *copy = *dex;
+    compactCarve(copy, block, dex->capacity);
+    return copy;
+}
+
+/* ------------------------------------------------------------
+   15) Frozen Pokedex (Eytzinger Layout for Read-Heavy Owners)
+   ------------------------------------------------------------ */
+
+#ifdef __GNUC__
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define PREFETCH(addr) ((void)(addr))
+#endif
+
+// 16-bit keys: the block 4 levels below k starts at 16k and fits one 64-byte line
+#define EYTZINGER_PREFETCH_STRIDE 16
+
+// An in-order walk of the Eytzinger positions consumes the sorted IDs in order
+static void eytzingerFill(const NodeArray *sorted, uint32_t *next, uint16_t *keys, uint32_t k, uint32_t size) {
+
+    if (k > size)
+        return;
+    eytzingerFill(sorted, next, keys, 2 * k, size);
+    keys[k] = (uint16_t)sorted->nodes[(*next)++]->data->id;
+    eytzingerFill(sorted, next, keys, 2 * k + 1, size);
+}
+
+/**
+ * @brief Drop the owner's frozen and engine copies; every mutation goes through this first.
+ * @param owner pointer to the Owner
+ * Why we made it: The copies don't follow the tree, so changes must invalidate them.
+ */
+void thawPokedex(OwnerNode *owner) {
+
+    dropEngineCopy(owner);
+    thawFrozenPokedex(owner);
+}
+
+/**
+ * @brief Drop only the owner's frozen copy; single-Pokemon changes go through this first.
+ * @param owner pointer to the Owner
+ * Why we made it: Adds, releases and evolves update the engine copy in place instead.
+ */
+void thawFrozenPokedex(OwnerNode *owner) {
+
+    if (!owner || !owner->frozen)
+        return;
+    arenaFree(owner->frozen->keys, ((size_t)owner->frozen->size + 1) * sizeof(uint16_t));
+    arenaFree(owner->frozen, sizeof(FrozenPokedex));
+    owner->frozen = NULL;
+}
+
+/**
+ * @brief Build the Eytzinger copy of an owner's Pokedex (replacing an old one).
+ * @param owner pointer to the Owner
+ * Why we made it: Owners that only fight/display/look up get cache-friendly searches.
+ */
+void freezePokedex(OwnerNode *owner) {
+
+    if (!owner)
+        return;
+    thawPokedex(owner);
+
+    int count = countPokemonNodes(owner->pokedexRoot);
+    if (count == 0)
+        return;
+
+    NodeArray sorted;
+    sorted.nodes = NULL;
+    initNodeArray(&sorted, count);
+    if (!sorted.nodes)
+        return;
+    collectAll(owner->pokedexRoot, &sorted);
+
+    FrozenPokedex *frozen = arenaAlloc(sizeof(FrozenPokedex));
+    uint16_t *keys = arenaAlloc(((size_t)count + 1) * sizeof(uint16_t));
+    if (!frozen || !keys) {
+        arenaFree(frozen, sizeof(FrozenPokedex));
+        arenaFree(keys, ((size_t)count + 1) * sizeof(uint16_t));
+        destroyNodeArray(&sorted);
+        return;
+    }
+
+    keys[0] = 0;
+    uint32_t next = 0;
+    eytzingerFill(&sorted, &next, keys, 1, (uint32_t)count);
+    frozen->keys = keys;
+    frozen->size = (uint32_t)count;
+    owner->frozen = frozen;
+    destroyNodeArray(&sorted);
+}
+
+/**
+ * @brief Branchless search of a frozen Pokedex.
+ * @param frozen pointer to the frozen Pokedex
+ * @param id ID to find
+ * @return species data, or NULL if not present
+ */
+const PokemonData *frozenSearch(const FrozenPokedex *frozen, int id) {
+
+    if (!frozen)
+        return NULL;
+
+    // Go right whenever keys[k] < id; the comparison result is the branch
+    const uint16_t *keys = frozen->keys;
+    uint32_t k = 1;
+    while (k <= frozen->size) {
+        PREFETCH(keys + EYTZINGER_PREFETCH_STRIDE * k);
+        k = 2 * k + (keys[k] < id);
+    }
+
+    // Undo the trailing right turns plus the final left turn to land on the lower bound
+    while (k & 1)
+        k >>= 1;
+    k >>= 1;
+
+    if (k == 0 || keys[k] != id)
+        return NULL;
+    return &pokedex[id - 1];
+}
+
+/**
+ * @brief Look up a species in an owner's Pokedex, via the frozen or engine copy if any.
+ * @param owner pointer to the Owner
+ * @param id ID to find
+ * @return species data, or NULL if the owner doesn't have it
+ */
+const PokemonData *ownerFindPokemon(OwnerNode *owner, int id) {
+
+    if (!owner)
+        return NULL;
+    if (owner->frozen)
+        return frozenSearch(owner->frozen, id);
+    void *copy = ownerEngineCopy(owner);
+    if (copy)
+        return lookupEngine->search(copy, id);
+
+    PokemonNode *node = searchPokemonBFS(owner->pokedexRoot, id);
+    return node ? node->data : NULL;
+}
+
+/**
+ * @brief Menu entry: freeze the owner's Pokedex for fast lookups.
+ * @param owner pointer to the Owner
+ */
+void freezePokedexMenu(OwnerNode *owner) {
+
+    if (!owner)
+        return;
+
+    if (owner->pokedexRoot == NULL) {
+        printf("Pokedex is empty.\n");
+        return;
+    }
+
+    freezePokedex(owner);
+    if (owner->frozen)
+        printf("Pokedex frozen for fast lookups (%u Pokemon). Any change will thaw it.\n",
+               owner->frozen->size);
+}
+
+/* ------------------------------------------------------------
+   16) B-Tree Pokedex
+   ------------------------------------------------------------ */
+
+static BTreeNode *btreeCreateNode(int leaf) {
+
+    BTreeNode *node = malloc(sizeof(BTreeNode));
+    if (!node)
+        return NULL;
+    node->count = 0;
+    node->leaf = (uint8_t)leaf;
+    return node;
+}
+
+static void btreeFreeNodes(BTreeNode *node) {
+
+    if (!node)
+        return;
+    if (!node->leaf) {
+        for (int i = 0; i <= node->count; i++)
+            btreeFreeNodes(node->children[i]);
+    }
+    free(node);
+}
+
+/**
+ * @brief Create an empty B-tree Pokedex.
+ * @return newly allocated BTreePokedex*, or NULL on failure
+ * Why we made it: Large collections spend fewer cache lines per level than a binary tree.
+ */
+BTreePokedex *createBTreePokedex(void) {
+
+    BTreePokedex *dex = malloc(sizeof(BTreePokedex));
+    if (!dex)
+        return NULL;
+    dex->root = NULL;
+    dex->count = 0;
+    return dex;
+}
+
+/**
+ * @brief Free a B-tree Pokedex and all of its nodes.
+ * @param dex pointer to the B-tree Pokedex (may be NULL)
+ */
+void freeBTreePokedex(BTreePokedex *dex) {
+
+    if (!dex)
+        return;
+    btreeFreeNodes(dex->root);
+    free(dex);
+}
+
+// Index of the first key >= id within one node (a scan over its key line)
+static int btreeLowerBound(const BTreeNode *node, int id) {
+
+    int i = 0;
+    while (i < node->count && node->keys[i] < id)
+        i++;
+    return i;
+}
+
+/**
+ * @brief Find a species by ID.
+ * @param dex pointer to the B-tree Pokedex
+ * @param id ID to find
+ * @return species data, or NULL if not present
+ */
+const PokemonData *btreeSearch(const BTreePokedex *dex, int id) {
+
+    if (!dex)
+        return NULL;
+
+    const BTreeNode *node = dex->root;
+    while (node) {
+        int i = btreeLowerBound(node, id);
+        if (i < node->count && node->keys[i] == id)
+            return &pokedex[id - 1];
+        node = node->leaf ? NULL : node->children[i];
+    }
+    return NULL;
+}
+
+// Split the full child i of parent around its median key (parent is not full)
+static int btreeSplitChild(BTreeNode *parent, int i) {
+
+    BTreeNode *full = parent->children[i];
+    BTreeNode *sibling = btreeCreateNode(full->leaf);
+    if (!sibling)
+        return 0;
+
+    sibling->count = BTREE_MIN_DEGREE - 1;
+    memcpy(sibling->keys, full->keys + BTREE_MIN_DEGREE, BTREE_MIN_DEGREE - 1);
+    if (!full->leaf)
+        memcpy(sibling->children, full->children + BTREE_MIN_DEGREE, BTREE_MIN_DEGREE * sizeof(BTreeNode *));
+    full->count = BTREE_MIN_DEGREE - 1;
+
+    memmove(parent->children + i + 2, parent->children + i + 1, (parent->count - i) * sizeof(BTreeNode *));
+    memmove(parent->keys + i + 1, parent->keys + i, parent->count - i);
+    parent->children[i + 1] = sibling;
+    parent->keys[i] = full->keys[BTREE_MIN_DEGREE - 1];
+    parent->count++;
+    return 1;
+}
+
+/**
+ * @brief Insert a species by ID; duplicates ignored (like insertPokemonNode).
+ * @param dex pointer to the B-tree Pokedex
+ * @param data species to insert (from the global pokedex)
+ * @return 1 if inserted, 0 if already present, -1 if out of memory
+ */
+int btreeInsert(BTreePokedex *dex, const PokemonData *data) {
+
+    if (!dex || !data)
+        return -1;
+    if (btreeSearch(dex, data->id))
+        return 0;
+
+    if (dex->root == NULL) {
+        dex->root = btreeCreateNode(1);
+        if (!dex->root)
+            return -1;
+    }
+
+    // Grow at the top: split a full root under a new one
+    if (dex->root->count == BTREE_MAX_KEYS) {
+        BTreeNode *newRoot = btreeCreateNode(0);
+        if (!newRoot)
+            return -1;
+        newRoot->children[0] = dex->root;
+        if (!btreeSplitChild(newRoot, 0)) {
+            free(newRoot);
+            return -1;
+        }
+        dex->root = newRoot;
+    }
+
+    // Split full children on the way down, so the leaf always has room
+    BTreeNode *node = dex->root;
+    while (!node->leaf) {
+        int i = btreeLowerBound(node, data->id);
+        if (node->children[i]->count == BTREE_MAX_KEYS) {
+            if (!btreeSplitChild(node, i))
+                return -1;
+            if (data->id > node->keys[i])
+                i++;
+        }
+        node = node->children[i];
+    }
+
+    int i = btreeLowerBound(node, data->id);
+    memmove(node->keys + i + 1, node->keys + i, node->count - i);
+    node->keys[i] = (uint8_t)data->id;
+    node->count++;
+    dex->count++;
+    return 1;
+}
+
+// Fold child i+1 and the separating key into child i
+static void btreeMergeChildren(BTreeNode *parent, int i) {
+
+    BTreeNode *left = parent->children[i];
+    BTreeNode *right = parent->children[i + 1];
+
+    left->keys[left->count] = parent->keys[i];
+    memcpy(left->keys + left->count + 1, right->keys, right->count);
+    if (!left->leaf)
+        memcpy(left->children + left->count + 1, right->children, (right->count + 1) * sizeof(BTreeNode *));
+    left->count = (uint8_t)(left->count + 1 + right->count);
+
+    memmove(parent->keys + i, parent->keys + i + 1, parent->count - i - 1);
+    memmove(parent->children + i + 1, parent->children + i + 2, (parent->count - i - 1) * sizeof(BTreeNode *));
+    parent->count--;
+    free(right);
+}
+
+// Make sure child i has at least BTREE_MIN_DEGREE keys before descending into it;
+// returns the index of the child to descend into (merging may shift it left)
+static int btreeFillChild(BTreeNode *parent, int i) {
+
+    BTreeNode *child = parent->children[i];
+    if (child->count >= BTREE_MIN_DEGREE)
+        return i;
+
+    if (i > 0 && parent->children[i - 1]->count >= BTREE_MIN_DEGREE) {
+        // Rotate the separator down and the left sibling's last key up
+        BTreeNode *left = parent->children[i - 1];
+        memmove(child->keys + 1, child->keys, child->count);
+        if (!child->leaf)
+            memmove(child->children + 1, child->children, (child->count + 1) * sizeof(BTreeNode *));
+        child->keys[0] = parent->keys[i - 1];
+        if (!child->leaf)
+            child->children[0] = left->children[left->count];
+        parent->keys[i - 1] = left->keys[left->count - 1];
+        left->count--;
+        child->count++;
+        return i;
+    }
+
+    if (i < parent->count && parent->children[i + 1]->count >= BTREE_MIN_DEGREE) {
+        // Rotate the separator down and the right sibling's first key up
+        BTreeNode *right = parent->children[i + 1];
+        child->keys[child->count] = parent->keys[i];
+        if (!child->leaf)
+            child->children[child->count + 1] = right->children[0];
+        child->count++;
+        parent->keys[i] = right->keys[0];
+        memmove(right->keys, right->keys + 1, right->count - 1);
+        if (!right->leaf)
+            memmove(right->children, right->children + 1, right->count * sizeof(BTreeNode *));
+        right->count--;
+        return i;
+    }
+
+    if (i < parent->count) {
+        btreeMergeChildren(parent, i);
+        return i;
+    }
+    btreeMergeChildren(parent, i - 1);
+    return i - 1;
+}
+
+/**
+ * @brief Remove a species by ID (like removeNodeBST).
+ * @param dex pointer to the B-tree Pokedex
+ * @param id ID to remove
+ * @return 1 if removed, 0 if not found
+ */
+int btreeRemove(BTreePokedex *dex, int id) {
+
+    if (!dex || !btreeSearch(dex, id))
+        return 0;
+
+    // Single pass down: every node we enter has a spare key, so nothing underflows
+    BTreeNode *node = dex->root;
+    while (1) {
+        int i = btreeLowerBound(node, id);
+        if (i < node->count && node->keys[i] == id) {
+            if (node->leaf) {
+                memmove(node->keys + i, node->keys + i + 1, node->count - i - 1);
+                node->count--;
+                break;
+            }
+            BTreeNode *left = node->children[i];
+            BTreeNode *right = node->children[i + 1];
+            if (left->count >= BTREE_MIN_DEGREE) {
+                // Replace with the predecessor, then delete that from the left subtree
+                BTreeNode *pred = left;
+                while (!pred->leaf)
+                    pred = pred->children[pred->count];
+                node->keys[i] = pred->keys[pred->count - 1];
+                id = node->keys[i];
+                node = left;
+            } else if (right->count >= BTREE_MIN_DEGREE) {
+                BTreeNode *succ = right;
+                while (!succ->leaf)
+                    succ = succ->children[0];
+                node->keys[i] = succ->keys[0];
+                id = node->keys[i];
+                node = right;
+            } else {
+                btreeMergeChildren(node, i);
+                node = left;
+            }
+            continue;
+        }
+        node = node->children[btreeFillChild(node, i)];
+    }
+
+    // Shrink at the top when the root ran out of keys
+    if (dex->root->count == 0) {
+        BTreeNode *oldRoot = dex->root;
+        dex->root = oldRoot->leaf ? NULL : oldRoot->children[0];
+        free(oldRoot);
+    }
+    dex->count--;
+    return 1;
+}
+
+// Node-level walk: pre-order lists a node's keys before its children, post-order after
+static void btreeWalk(const BTreeNode *node, TraversalOrder order, VisitNodeFunc visit) {
+
+    if (!node)
+        return;
+
+    if (order == ORDER_PRE)
+        for (int i = 0; i < node->count; i++)
+            visitSpeciesView(node->keys[i], visit);
+
+    for (int i = 0; i <= node->count; i++) {
+        if (!node->leaf)
+            btreeWalk(node->children[i], order, visit);
+        if (order == ORDER_IN && i < node->count)
+            visitSpeciesView(node->keys[i], visit);
+    }
+
+    if (order == ORDER_POST)
+        for (int i = 0; i < node->count; i++)
+            visitSpeciesView(node->keys[i], visit);
+}
+
+/**
+ * @brief Walk the B-tree in the given order, calling visit() like the *Generic walkers.
+ * @param dex pointer to the B-tree Pokedex
+ * @param order BFS (node by node, level order), pre-, in- or post-order
+ * @param visit receives a PokemonNode view of each key
+ */
+void btreeTraverse(const BTreePokedex *dex, TraversalOrder order, VisitNodeFunc visit) {
+
+    if (!dex || !dex->root)
+        return;
+
+    if (order != ORDER_BFS) {
+        // Height is logarithmic in the fan-out, so recursion depth stays tiny
+        btreeWalk(dex->root, order, visit);
+        return;
+    }
+
+    // Every node holds at least one key, so there are never more nodes than keys
+    const BTreeNode **queue = malloc(dex->count * sizeof(BTreeNode *));
+    if (!queue)
+        return;
+    uint32_t size = 0;
+    queue[size++] = dex->root;
+    for (uint32_t head = 0; head < size; head++) {
+        const BTreeNode *node = queue[head];
+        for (int i = 0; i < node->count; i++)
+            visitSpeciesView(node->keys[i], visit);
+        if (!node->leaf)
+            for (int i = 0; i <= node->count; i++)
+                queue[size++] = node->children[i];
+    }
+    free(queue);
+}
+
+/* ------------------------------------------------------------
+   17) Selectable Pokedex Engines
+   ------------------------------------------------------------ */
+
+// "bst": the PokemonNode tree the owners use, behind a handle
+typedef struct {
+    PokemonNode *root;
+} BSTEngineHandle;
+
+static void *bstEngineCreate(void) {
+
+    BSTEngineHandle *handle = malloc(sizeof(BSTEngineHandle));
+    if (handle)
+        handle->root = NULL;
+    return handle;
+}
+
+static void bstEngineDestroy(void *dex) {
+
+    BSTEngineHandle *handle = dex;
+    freePokemonTree(handle->root);
+    free(handle);
+}
+
+static int bstEngineInsert(void *dex, const PokemonData *data) {
+
+    BSTEngineHandle *handle = dex;
+    if (searchPokemonBST(handle->root, data->id))
+        return 0;
+    PokemonNode *node = createPokemonNode(data);
+    if (!node)
+        return -1;
+    handle->root = insertPokemonNode(handle->root, node);
+    return 1;
+}
+
+static int bstEngineRemove(void *dex, int id) {
+
+    BSTEngineHandle *handle = dex;
+    if (!searchPokemonBST(handle->root, id))
+        return 0;
+    handle->root = removeNodeBST(handle->root, id);
+    return 1;
+}
+
+static const PokemonData *bstEngineSearch(void *dex, int id) {
+
+    PokemonNode *node = searchPokemonBST(((BSTEngineHandle *)dex)->root, id);
+    return node ? node->data : NULL;
+}
+
+static void bstEngineTraverse(void *dex, TraversalOrder order, VisitNodeFunc visit) {
+
+    PokemonNode *root = ((BSTEngineHandle *)dex)->root;
+    switch (order) {
+    case ORDER_BFS:
+        BFSGeneric(root, visit);
+        break;
+    case ORDER_PRE:
+        preOrderGeneric(root, visit);
+        break;
+    case ORDER_IN:
+        inOrderGeneric(root, visit);
+        break;
+    case ORDER_POST:
+        postOrderGeneric(root, visit);
+        break;
+    }
+}
+
+// "compact": the array-indexed layout from section 14
+static void *compactEngineCreate(void) {
+
+    return createCompactPokedex(0);
+}
+
+static void compactEngineDestroy(void *dex) {
+
+    freeCompactPokedex(dex);
+}
+
+static int compactEngineInsert(void *dex, const PokemonData *data) {
+
+    return compactInsert(dex, data);
+}
+
+static int compactEngineRemove(void *dex, int id) {
+
+    return compactRemove(dex, id);
+}
+
+static const PokemonData *compactEngineSearch(void *dex, int id) {
+
+    return compactSearch(dex, id);
+}
+
+static void compactEngineTraverse(void *dex, TraversalOrder order, VisitNodeFunc visit) {
+
+    compactTraverse(dex, order, visit);
+}
+
+static void *compactEngineCopy(void *dex) {
+
+    return compactSnapshot(dex);
+}
+
+// "btree": the multi-key nodes from section 16
+static void *btreeEngineCreate(void) {
+
+    return createBTreePokedex();
+}
+
+static void btreeEngineDestroy(void *dex) {
+
+    freeBTreePokedex(dex);
+}
+
+static int btreeEngineInsert(void *dex, const PokemonData *data) {
+
+    return btreeInsert(dex, data);
+}
+
+static int btreeEngineRemove(void *dex, int id) {
+
+    return btreeRemove(dex, id);
+}
+
+static const PokemonData *btreeEngineSearch(void *dex, int id) {
+
+    return btreeSearch(dex, id);
+}
+
+static void btreeEngineTraverse(void *dex, TraversalOrder order, VisitNodeFunc visit) {
+
+    btreeTraverse(dex, order, visit);
+}
+
+// "treap": the access-count treap from section 18
+static void *treapEngineCreate(void) {
+
+    return createTreapPokedex();
+}
+
+static void treapEngineDestroy(void *dex) {
+
+    freeTreapPokedex(dex);
+}
+
+static int treapEngineInsert(void *dex, const PokemonData *data) {
+
+    return treapInsert(dex, data);
+}
+
+static int treapEngineRemove(void *dex, int id) {
+
+    return treapRemove(dex, id);
+}
+
+static const PokemonData *treapEngineSearch(void *dex, int id) {
+
+    return treapSearch(dex, id);
+}
+
+static void treapEngineTraverse(void *dex, TraversalOrder order, VisitNodeFunc visit) {
+
+    treapTraverse(dex, order, visit);
+}
+
+static const PokedexEngine pokedexEngines[] = {
+    {"bst", bstEngineCreate, bstEngineDestroy, bstEngineInsert, bstEngineRemove,
+     bstEngineSearch, bstEngineTraverse, NULL},
+    {"compact", compactEngineCreate, compactEngineDestroy, compactEngineInsert, compactEngineRemove,
+     compactEngineSearch, compactEngineTraverse, compactEngineCopy},
+    {"btree", btreeEngineCreate, btreeEngineDestroy, btreeEngineInsert, btreeEngineRemove,
+     btreeEngineSearch, btreeEngineTraverse, NULL},
+    {"treap", treapEngineCreate, treapEngineDestroy, treapEngineInsert, treapEngineRemove,
+     treapEngineSearch, treapEngineTraverse, NULL},
+};
+
+/**
+ * @brief Look up a Pokedex engine by name.
+ * @param name engine name ("bst", "compact", "btree", ...)
+ * @return the engine, or NULL if there is none by that name
+ * Why we made it: Callers and benchmarks pick a backend by name behind one interface.
+ */
+const PokedexEngine *findPokedexEngine(const char *name) {
+
+    if (name == NULL)
+        return NULL;
+    for (size_t i = 0; i < sizeof(pokedexEngines) / sizeof(pokedexEngines[0]); i++) {
+        if (strcmp(pokedexEngines[i].name, name) == 0)
+            return &pokedexEngines[i];
+    }
+    return NULL;
+}
+
+typedef struct {
+    const PokedexEngine *engine;
+    void *dex;
+} EngineFill;
+
+static TraverseResult visitEngineInsert(PokemonNode *node, void *ctx) {
+
+    EngineFill *fill = ctx;
+    return fill->engine->insert(fill->dex, node->data) < 0 ? TRAVERSE_STOP : TRAVERSE_CONTINUE;
+}
+
+/**
+ * @brief Get the owner's Pokedex in lookupEngine's backend, building it on first use.
+ * @param owner pointer to the Owner
+ * @return engine handle, or NULL if there's no lookupEngine or memory ran out
+ * Why we made it: Lookups, displays and single-Pokemon changes run on the selected
+ * backend, built once per owner rather than per query.
+ */
+void *ownerEngineCopy(OwnerNode *owner) {
+
+    if (!owner || !lookupEngine)
+        return NULL;
+    if (owner->engineCopy)
+        return owner->engineCopy;
+
+    // Level order, so tree-shaped backends start out with the owner's shape
+    EngineFill fill = {lookupEngine, lookupEngine->create()};
+    if (!fill.dex)
+        return NULL;
+    if (BFSGenericCtx(owner->pokedexRoot, visitEngineInsert, &fill) == TRAVERSE_STOP) {
+        lookupEngine->destroy(fill.dex);
+        return NULL;
+    }
+    owner->engineCopy = fill.dex;
+    return fill.dex;
+}
+
+/**
+ * @brief Apply an add to the owner's engine copy, if it has one.
+ * @param owner pointer to the Owner
+ * @param data species added to the tree
+ */
+void engineCopyInsert(OwnerNode *owner, const PokemonData *data) {
+
+    // A copy missing a Pokemon would answer lookups wrongly; drop it and rebuild later
+    if (owner && owner->engineCopy && lookupEngine->insert(owner->engineCopy, data) < 0)
+        dropEngineCopy(owner);
+}
+
+/**
+ * @brief Apply a release to the owner's engine copy, if it has one.
+ * @param owner pointer to the Owner
+ * @param id ID released from the tree
+ */
+void engineCopyRemove(OwnerNode *owner, int id) {
+
+    if (owner && owner->engineCopy)
+        lookupEngine->remove(owner->engineCopy, id);
+}
+
+/**
+ * @brief Drop the owner's engine copy (thawPokedex does this on every bulk change).
+ * @param owner pointer to the Owner
+ */
+void dropEngineCopy(OwnerNode *owner) {
+
+    if (!owner || !owner->engineCopy)
+        return;
+    lookupEngine->destroy(owner->engineCopy);
+    owner->engineCopy = NULL;
+}
+
+/**
+ * @brief Drop the engine copy kept with the owner's undo snapshot.
+ * @param owner pointer to the Owner
+ */
+void dropEngineSnapshot(OwnerNode *owner) {
+
+    if (!owner || !owner->engineSnapshot)
+        return;
+    lookupEngine->destroy(owner->engineSnapshot);
+    owner->engineSnapshot = NULL;
+}
+
+/**
+ * @brief Copy an engine handle with lookupEngine's copy operation.
+ * @param dex engine handle (may be NULL)
+ * @return independent copy, or NULL if there's nothing to copy, no copy operation or no memory
+ * Why we made it: A clone starts with its source's engine copy instead of rebuilding it.
+ */
+void *copyEngineDex(void *dex) {
+
+    if (!dex || !lookupEngine->copy)
+        return NULL;
+    return lookupEngine->copy(dex);
+}
+
+/* ------------------------------------------------------------
+   18) Treap Pokedex (Self-Adjusting by Access Counts)
+   ------------------------------------------------------------ */
+
+/*
+ * The lookup count is the treap priority. A lookup bumps it and rotates the node up
+ * past every parent it has overtaken, so hot IDs settle near the root. Unlike a splay
+ * tree, a lookup that overtakes nobody (nearly all of them, once the counts have spread
+ * out) only reads the tree, and a cold ID can't push the hot ones down.
+ */
+
+// Halve every count before one overflows; halving keeps the heap order
+static void treapAgeHits(TreapPokedex *dex) {
+
+    for (int id = 1; id <= POKEDEX_SIZE; id++)
+        dex->hits[id] /= 2;
+}
+
+/**
+ * @brief Create an empty access-count treap Pokedex.
+ * @return newly allocated TreapPokedex*, or NULL on failure
+ * Why we made it: Popular species (starters, Pikachu) rise to the root and stay there.
+ */
+TreapPokedex *createTreapPokedex(void) {
+
+    TreapPokedex *dex = calloc(1, sizeof(TreapPokedex) + (POKEDEX_SIZE + 1) * sizeof(uint32_t));
+    if (!dex)
+        return NULL;
+    dex->root = NULL;
+    return dex;
+}
+
+/**
+ * @brief Free a treap Pokedex and all of its nodes.
+ * @param dex pointer to the treap Pokedex (may be NULL)
+ */
+void freeTreapPokedex(TreapPokedex *dex) {
+
+    if (!dex)
+        return;
+    freePokemonTree(dex->root);
+    free(dex);
+}
+
+/**
+ * @brief Find a species by ID, count the hit and rotate it above any parent it overtook.
+ * @param dex pointer to the treap Pokedex
+ * @param id ID to find
+ * @return species data, or NULL if not present
+ */
+const PokemonData *treapSearch(TreapPokedex *dex, int id) {
+
+    if (!dex)
+        return NULL;
+
+    PokemonNode *parent = NULL;
+    PokemonNode *node = dex->root;
+    while (node != NULL && node->data->id != id) {
+        parent = node;
+        node = (id < node->data->id) ? node->left : node->right;
+    }
+    if (node == NULL)
+        return NULL;
+
+    if (dex->hits[id] == UINT32_MAX)
+        treapAgeHits(dex);
+    uint32_t hits = ++dex->hits[id];
+    if (parent == NULL || dex->hits[parent->data->id] >= hits)
+        return node->data;
+
+    // It overtook its parent: find the links down to it again, then rotate it up
+    PokemonNode **path[POKEDEX_SIZE];
+    int depth = 0;
+    PokemonNode **link = &dex->root;
+    while (*link != node) {
+        path[depth++] = link;
+        link = (id < (*link)->data->id) ? &(*link)->left : &(*link)->right;
+    }
+    while (depth > 0 && dex->hits[(*path[depth - 1])->data->id] < hits) {
+        PokemonNode **parentLink = path[--depth];
+        PokemonNode *up = *parentLink;
+        if (up->left == node) {
+            up->left = node->right;
+            node->right = up;
+        } else {
+            up->right = node->left;
+            node->left = up;
+        }
+        *parentLink = node;
+    }
+    return node->data;
+}
+
+/**
+ * @brief Insert a species by ID as a leaf with no hits yet; duplicates ignored.
+ * @param dex pointer to the treap Pokedex
+ * @param data species to insert (from the global pokedex)
+ * @return 1 if inserted, 0 if already present, -1 if out of memory
+ */
+int treapInsert(TreapPokedex *dex, const PokemonData *data) {
+
+    if (!dex || !data)
+        return -1;
+
+    PokemonNode **link = &dex->root;
+    while (*link != NULL) {
+        if ((*link)->data->id == data->id)
+            return 0;
+        link = (data->id < (*link)->data->id) ? &(*link)->left : &(*link)->right;
+    }
+
+    // No hits is the lowest priority, so a new leaf never breaks the heap order
+    PokemonNode *node = createPokemonNode(data);
+    if (!node)
+        return -1;
+    dex->hits[data->id] = 0;
+    *link = node;
+    dex->count++;
+    return 1;
+}
+
+/**
+ * @brief Remove a species by ID (like removeNodeBST), rotating it down to a leaf first.
+ * @param dex pointer to the treap Pokedex
+ * @param id ID to remove
+ * @return 1 if removed, 0 if not found
+ */
+int treapRemove(TreapPokedex *dex, int id) {
+
+    if (!dex)
+        return 0;
+
+    PokemonNode **link = &dex->root;
+    while (*link != NULL && (*link)->data->id != id)
+        link = (id < (*link)->data->id) ? &(*link)->left : &(*link)->right;
+    PokemonNode *target = *link;
+    if (target == NULL)
+        return 0;
+
+    // The busier child takes its place each step, which keeps the heap order
+    while (target->left != NULL && target->right != NULL) {
+        PokemonNode *child;
+        if (dex->hits[target->left->data->id] >= dex->hits[target->right->data->id]) {
+            child = target->left;
+            target->left = child->right;
+            child->right = target;
+            *link = child;
+            link = &child->right;
+        } else {
+            child = target->right;
+            target->right = child->left;
+            child->left = target;
+            *link = child;
+            link = &child->left;
+        }
+    }
+    *link = target->left ? target->left : target->right;
+    freePokemonNode(target);
+    dex->count--;
+    return 1;
+}
+
+/**
+ * @brief Walk the treap in the given order (counts no hits).
+ * @param dex pointer to the treap Pokedex
+ * @param order BFS, pre-, in- or post-order
+ * @param visit function pointer
+ */
+void treapTraverse(TreapPokedex *dex, TraversalOrder order, VisitNodeFunc visit) {
+
+    if (!dex)
+        return;
+
+    // Treap nodes are plain PokemonNodes, so the generic walkers apply as-is
+    switch (order) {
+    case ORDER_BFS:
+        BFSGeneric(dex->root, visit);
+        break;
+    case ORDER_PRE:
+        preOrderGeneric(dex->root, visit);
+        break;
+    case ORDER_IN:
+        inOrderGeneric(dex->root, visit);
+        break;
+    case ORDER_POST:
+        postOrderGeneric(dex->root, visit);
+        break;
+    }
+}
+
+/* ------------------------------------------------------------
+   19) Shared Pokedexes: Undo Snapshots, Clones, Joins
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Remember the owner's Pokedex before a bulk change (replacing the old snapshot).
+ * @param owner pointer to the Owner
+ * Why we made it: Bulk add, evolve-all and merge can't be undone one Pokemon at a time.
+ * The snapshot shares the live tree's nodes, so taking it is O(1).
+ */
+void snapshotPokedex(OwnerNode *owner) {
+
+    if (!owner)
+        return;
+
+    freePokemonTree(owner->snapshot);
+    owner->snapshot = retainPokemonTree(owner->pokedexRoot);
+    owner->hasSnapshot = 1;
+
+    // The bulk change would drop the engine copy anyway, so the snapshot keeps it
+    dropEngineSnapshot(owner);
+    owner->engineSnapshot = owner->engineCopy;
+    owner->engineCopy = NULL;
+}
+
+/**
+ * @brief Menu entry: put back the Pokedex saved before the last bulk change.
+ * @param owner pointer to the Owner
+ */
+void restorePokedexSnapshot(OwnerNode *owner) {
+
+    if (!owner)
+        return;
+
+    if (!owner->hasSnapshot) {
+        printf("No bulk change to undo.\n");
+        return;
+    }
+
+    // The snapshot's reference becomes the live tree's
+    thawPokedex(owner);
+    freePokemonTree(owner->pokedexRoot);
+    owner->pokedexRoot = owner->snapshot;
+    owner->snapshot = NULL;
+    owner->hasSnapshot = 0;
+    owner->engineCopy = owner->engineSnapshot;
+    owner->engineSnapshot = NULL;
+    recountTombstones(owner);
+    printf("Restored %s's Pokedex to before the last bulk change.\n", owner->ownerName);
+}
+
+/**
+ * @brief Join another tree onto a BST when their ID ranges don't overlap (O(height)).
+ * @param root pointer to the BST root (updated; still valid if the join fails)
+ * @param other tree to join (shared, not consumed)
+ * @return 1 if joined, 0 if the ranges overlap, -1 if out of memory
+ * Why we made it: Merging a disjoint Pokedex hangs it off the new root instead of
+ * copying it node by node; only the path to the lower tree's maximum is copied.
+ */
+int joinPokemonTrees(PokemonNode **root, PokemonNode *other) {
+
+    if (other == NULL)
+        return 1;
+    if (*root == NULL) {
+        *root = retainPokemonTree(other);
+        return 1;
+    }
+
+    const PokemonNode *maxRoot = *root;
+    while (maxRoot->right)
+        maxRoot = maxRoot->right;
+    const PokemonNode *maxOther = other;
+    while (maxOther->right)
+        maxOther = maxOther->right;
+
+    // Each side holds one reference: *root's moves over, other gets a new one
+    PokemonNode *low, *high;
+    int rootIsLow = maxRoot->data->id < findMin(other)->data->id;
+    if (rootIsLow) {
+        low = *root;
+        high = retainPokemonTree(other);
+    } else if (maxOther->data->id < findMin(*root)->data->id) {
+        low = retainPokemonTree(other);
+        high = *root;
+    } else {
+        return 0;
+    }
+
+    // Unlink low's maximum, copying its right spine wherever it is shared
+    PokemonNode **link = &low;
+    PokemonNode *top;
+    for (;;) {
+        top = ownPokemonNode(*link);
+        if (top == NULL) {
+            // A partly copied spine is still the same tree, so only other's reference goes
+            if (rootIsLow) {
+                *root = low;
+                freePokemonTree(high);
+            } else {
+                freePokemonTree(low);
+            }
+            return -1;
+        }
+        *link = top;
+        if (top->right == NULL)
+            break;
+        link = &top->right;
+    }
+    *link = top->left;
+
+    // low's maximum becomes the new root, with the rest of low on its left
+    top->left = low;
+    top->right = high;
+    *root = top;
+    return 1;
+}
+
+/**
+ * @brief Share an owner's Pokedex with a new owner, undo snapshot included (O(1)).
+ * Why we made it: Lets a player branch off an existing collection and try things out.
+ */
+void cloneOwnerMenu(void) {
+
+    printf("=== Clone a Pokedex ===\n");
+    int cnt = printAndCountOwners();
+    if (cnt == 0) {
+        printf("No existing Pokedexes.\n");
+        return;
+    }
+    int choice = readIntSafe("Choose a Pokedex to clone by number: ");
+    if (choice > cnt)
+        return;
+    OwnerNode *source = findOwnerByNum(choice);
+    if (!source)
+        return;
+
+    printf("New owner's name: ");
+    char *ownerName = getDynamicInput();
+    if (!ownerName)
+        return;
+    if (findOwnerByName(ownerName)) {
+        printf("Owner '%s' already exists. Not cloning.\n", ownerName);
+        free(ownerName);
+        return;
+    }
+
+    // Both trees are shared, not copied; whichever owner changes first copies what it touches
+    OwnerNode *clone = createOwner(ownerName, source->pokedexRoot);
+    if (!clone) {
+        free(ownerName);
+        return;
+    }
+    retainPokemonTree(clone->pokedexRoot);
+    clone->snapshot = retainPokemonTree(source->snapshot);
+    clone->hasSnapshot = source->hasSnapshot;
+    clone->engineCopy = copyEngineDex(source->engineCopy);
+    clone->engineSnapshot = copyEngineDex(source->engineSnapshot);
+    clone->lazyRelease = source->lazyRelease;
+    clone->deadCount = source->deadCount;
+    clone->deadCheckAt = source->deadCheckAt;
+    linkOwnerInCircularList(clone);
+    printf("Cloned %s's Pokedex into a new Pokedex for %s.\n", source->ownerName, clone->ownerName);
+}
+
+/* ------------------------------------------------------------
+   20) Lazy Release (Tombstones)
+   ------------------------------------------------------------ */
+
+// Compact once a quarter of the tree's nodes are tombstones
+#define DEAD_FRACTION_DIVISOR 4
+
+// Count every node, tombstones included (the walkers above skip them)
+static void countTreeNodes(PokemonNode *root, int *total, int *dead) {
+
+    *total = 0;
+    *dead = 0;
+    NodeArray stack;
+    if (root == NULL || !initWalkStack(&stack))
+        return;
+
+    addNode(&stack, root);
+    while (stack.size > 0) {
+        PokemonNode *current = popNode(&stack);
+        (*total)++;
+        if (current->dead)
+            (*dead)++;
+        if (current->right)
+            addNode(&stack, current->right);
+        if (current->left)
+            addNode(&stack, current->left);
+    }
+    destroyNodeArray(&stack);
+}
+
+// Next deadCount at which the dead fraction could have crossed the threshold
+static int nextDeadCheck(int total) {
+
+    int at = (total + DEAD_FRACTION_DIVISOR - 1) / DEAD_FRACTION_DIVISOR;
+    return at > 0 ? at : 1;
+}
+
+/**
+ * @brief Drop the owner's tombstones now (no-op when there are none).
+ * @param owner pointer to the Owner
+ * Why we made it: Bulk operations relink nodes and must only ever see live ones.
+ */
+void compactPokedex(OwnerNode *owner) {
+
+    if (!owner || owner->deadCount == 0)
+        return;
+
+    owner->pokedexRoot = purgeDeadNodes(owner->pokedexRoot);
+    // Only non-zero afterwards if the rebuild ran out of memory
+    recountTombstones(owner);
+}
+
+/**
+ * @brief Re-count the owner's tombstones and schedule the next check.
+ * @param owner pointer to the Owner
+ * Why we made it: A restored snapshot may hold tombstones the counter doesn't know about.
+ */
+void recountTombstones(OwnerNode *owner) {
+
+    int total, dead;
+    countTreeNodes(owner->pokedexRoot, &total, &dead);
+    owner->deadCount = dead;
+    owner->deadCheckAt = nextDeadCheck(total);
+}
+
+/**
+ * @brief Release a Pokemon by leaving a tombstone, compacting once enough pile up.
+ * @param owner pointer to the Owner
+ * @param id ID to release
+ * @return 1 if released, 0 if the owner doesn't have it
+ */
+int releasePokemonLazy(OwnerNode *owner, int id) {
+
+    if (!owner || !markPokemonDead(&owner->pokedexRoot, id))
+        return 0;
+
+    // deadCount over-counts tombstones revived by a later add; the recount fixes that
+    if (++owner->deadCount < owner->deadCheckAt)
+        return 1;
+
+    int total, dead;
+    countTreeNodes(owner->pokedexRoot, &total, &dead);
+    owner->deadCount = dead;
+    if (dead * DEAD_FRACTION_DIVISOR >= total)
+        compactPokedex(owner);
+    else
+        owner->deadCheckAt = nextDeadCheck(total);
+    return 1;
+}
+
+/**
+ * @brief Menu entry: switch lazy release on or off (off compacts right away).
+ * @param owner pointer to the Owner
+ */
+void toggleLazyRelease(OwnerNode *owner) {
+
+    if (!owner)
+        return;
+
+    if (owner->lazyRelease) {
+        compactPokedex(owner);
+        owner->lazyRelease = 0;
+        printf("Lazy release off.\n");
+        return;
+    }
+
+    owner->lazyRelease = 1;
+    owner->deadCheckAt = nextDeadCheck(countPokemonNodes(owner->pokedexRoot));
+    printf("Lazy release on: released Pokemon are hidden at once and cleared out in batches.\n");
+}
+
+/* ------------------------------------------------------------
+   21) Process Arena
+   ------------------------------------------------------------ */
+
+#ifndef ARENA_DEBUG
+
+// Size classes are powers of two from ARENA_MIN_CLASS up to ARENA_MAX_CLASS bytes
+#define ARENA_MIN_CLASS 16
+#define ARENA_MAX_CLASS 512
+#define ARENA_CLASS_COUNT 6
+#define ARENA_CHUNK_BYTES (64 * 1024)
+
+typedef struct ArenaChunk {
+    struct ArenaChunk *next;
+    size_t used;
+    size_t capacity;
+} ArenaChunk;
+
+// Chunk payloads start after the header, rounded up so every class stays 16-aligned
+#define ARENA_HEADER_BYTES ((sizeof(ArenaChunk) + ARENA_MIN_CLASS - 1) & ~(size_t)(ARENA_MIN_CLASS - 1))
+
+// A freed block holds the link to the next free block of its class
+typedef struct ArenaFreeBlock {
+    struct ArenaFreeBlock *next;
+} ArenaFreeBlock;
+
+static ArenaChunk *arenaChunks;
+static ArenaFreeBlock *arenaFreeLists[ARENA_CLASS_COUNT];
+
+// Server workers allocate for different owners at the same time
+static pthread_mutex_t arenaLock = PTHREAD_MUTEX_INITIALIZER;
+
+static int arenaClassOf(size_t size) {
+
+    int cls = 0;
+    size_t classSize = ARENA_MIN_CLASS;
+    while (classSize < size) {
+        classSize <<= 1;
+        cls++;
+    }
+    return cls;
+}
+
+// Bump-allocate from the newest chunk, starting a new one when it's full
+static void *arenaCarve(size_t bytes) {
+
+    if (!arenaChunks || arenaChunks->capacity - arenaChunks->used < bytes) {
+        // Oversized requests get a chunk of their own
+        size_t capacity = bytes > ARENA_CHUNK_BYTES ? bytes : ARENA_CHUNK_BYTES;
+        ArenaChunk *chunk = malloc(ARENA_HEADER_BYTES + capacity);
+        if (!chunk)
+            return NULL;
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        if (!arenaChunks || bytes <= ARENA_CHUNK_BYTES) {
+            chunk->next = arenaChunks;
+            arenaChunks = chunk;
+        } else {
+            // Keep the current chunk in front so its free space isn't abandoned
+            chunk->next = arenaChunks->next;
+            arenaChunks->next = chunk;
+            chunk->used = bytes;
+            return (unsigned char *)chunk + ARENA_HEADER_BYTES;
+        }
+    }
+
+    void *ptr = (unsigned char *)arenaChunks + ARENA_HEADER_BYTES + arenaChunks->used;
+    arenaChunks->used += bytes;
+    return ptr;
+}
+
+/**
+ * @brief Allocate size bytes from the process arena.
+ * @param size bytes wanted
+ * @return pointer to uninitialized memory, or NULL if out of memory
+ */
+void *arenaAlloc(size_t size) {
+
+    if (size == 0)
+        size = 1;
+
+    void *ptr;
+    pthread_mutex_lock(&arenaLock);
+    if (size > ARENA_MAX_CLASS) {
+        // Too big for a class: rounded to 16 bytes, reclaimed only by arenaReset()
+        ptr = arenaCarve((size + ARENA_MIN_CLASS - 1) & ~(size_t)(ARENA_MIN_CLASS - 1));
+    } else {
+        int cls = arenaClassOf(size);
+        ArenaFreeBlock *block = arenaFreeLists[cls];
+        if (block) {
+            arenaFreeLists[cls] = block->next;
+            ptr = block;
+        } else {
+            ptr = arenaCarve((size_t)ARENA_MIN_CLASS << cls);
+        }
+    }
+    pthread_mutex_unlock(&arenaLock);
+    return ptr;
+}
+
+/**
+ * @brief Give memory back to the arena's free list for its size class.
+ * @param ptr pointer from arenaAlloc (may be NULL)
+ * @param size the size passed to arenaAlloc
+ */
+void arenaFree(void *ptr, size_t size) {
+
+    if (!ptr || size > ARENA_MAX_CLASS)
+        return;
+
+    int cls = arenaClassOf(size ? size : 1);
+    ArenaFreeBlock *block = ptr;
+    pthread_mutex_lock(&arenaLock);
+    block->next = arenaFreeLists[cls];
+    arenaFreeLists[cls] = block;
+    pthread_mutex_unlock(&arenaLock);
+}
+
+/**
+ * @brief Release every arena allocation at once; all arena pointers become invalid.
+ * Why we made it: Tearing down millions of nodes one free() at a time made exit slow.
+ */
+void arenaReset(void) {
+
+    // One free() per 64 KiB chunk, however many objects were carved from it
+    pthread_mutex_lock(&arenaLock);
+    while (arenaChunks) {
+        ArenaChunk *next = arenaChunks->next;
+        free(arenaChunks);
+        arenaChunks = next;
+    }
+    memset(arenaFreeLists, 0, sizeof(arenaFreeLists));
+    pthread_mutex_unlock(&arenaLock);
+}
+
+#else
+
+void *arenaAlloc(size_t size) {
+
+    return malloc(size ? size : 1);
+}
+
+void arenaFree(void *ptr, size_t size) {
+
+    (void)size;
+    free(ptr);
+}
+
+void arenaReset(void) {
+}
+
+#endif
+
+/**
+ * @brief Copy a string into the arena.
+ * @param str string to copy
+ * @return arena copy (free with arenaFree(copy, strlen(copy) + 1)), or NULL
+ */
+char *arenaStrdup(const char *str) {
+
+    if (!str)
+        return NULL;
+    size_t size = strlen(str) + 1;
+    char *copy = arenaAlloc(size);
+    if (copy)
+        memcpy(copy, str, size);
+    return copy;
+}
+
+/* ------------------------------------------------------------
+   22) Server Mode (Unix Domain Socket)
+   ------------------------------------------------------------ */
+
+#define SERVER_WORKERS 4
+#define SERVER_MAX_EVENTS 64
+#define SERVER_READ_CHUNK 4096
+#define SERVER_MAX_LINE (64 * 1024)
+#define SERVER_TOKEN_MAX 512
+
+static volatile sig_atomic_t serverStopRequested;
+
+typedef struct ServerClient {
+    int fd;
+    char *in;                       // bytes received but not yet dispatched
+    size_t inLen;
+    size_t inCap;
+    char *line;                     // command handed to a worker
+    int busy;                       // a job is queued or running (fd is out of epoll)
+    struct ServerClient *nextJob;   // job queue link
+    struct ServerClient *prev;      // all-clients list, for shutdown
+    struct ServerClient *next;
+} ServerClient;
+
+typedef struct {
+    ServerClient *client;
+    CommandResult result;
+} ServerDone;
+
+typedef struct {
+    int listenFd;
+    int epollFd;
+    int donePipe[2];                // workers -> event loop: finished jobs
+    pthread_mutex_t queueLock;
+    pthread_cond_t queueReady;
+    ServerClient *jobHead;
+    ServerClient *jobTail;
+    ServerClient *clients;
+    int stopping;
+    pthread_t workers[SERVER_WORKERS];
+} Server;
+
+// Owner names in commands are single tokens, so look them up directly
+static OwnerNode *commandOwner(const char *name, FILE *out) {
+
+    OwnerNode *owner = name ? findOwnerByName(name) : NULL;
+    if (!owner)
+        fprintf(out, "ERR no such owner\n");
+    return owner;
+}
+
+static int commandInt(const char *token, int *value) {
+
+    if (!token)
+        return 0;
+    char *end;
+    long parsed = strtol(token, &end, 10);
+    if (end == token || *end != '\0' || parsed < -1000000 || parsed > 1000000)
+        return 0;
+    *value = (int)parsed;
+    return 1;
+}
+
+static TraverseResult visitWritePokemon(PokemonNode *node, void *ctx) {
+
+    writePokemonNode(ctx, node);
+    return TRAVERSE_CONTINUE;
+}
+
+static void commandShow(PokemonNode *root, const char *order, FILE *out) {
+
+    if (!order) {
+        fprintf(out, "ERR usage: SHOW <owner> BFS|PRE|IN|POST|ALPHA\n");
+        return;
+    }
+    if (compareNamesNoCase(order, "BFS") != 0 && compareNamesNoCase(order, "PRE") != 0 &&
+        compareNamesNoCase(order, "IN") != 0 && compareNamesNoCase(order, "POST") != 0 &&
+        compareNamesNoCase(order, "ALPHA") != 0) {
+        fprintf(out, "ERR unknown order\n");
+        return;
+    }
+
+    fprintf(out, "OK\n");
+    if (!root) {
+        fprintf(out, "Pokedex is empty.\n");
+        return;
+    }
+    if (compareNamesNoCase(order, "BFS") == 0)
+        BFSGenericCtx(root, visitWritePokemon, out);
+    else if (compareNamesNoCase(order, "PRE") == 0)
+        preOrderGenericCtx(root, visitWritePokemon, out);
+    else if (compareNamesNoCase(order, "IN") == 0)
+        inOrderGenericCtx(root, visitWritePokemon, out);
+    else if (compareNamesNoCase(order, "POST") == 0)
+        postOrderGenericCtx(root, visitWritePokemon, out);
+    else
+        writeAlphabetical(out, root);
+}
+
+// Looks the IDs up in the owner's engine copy when given one (owner locked), else in root
+static void commandFight(PokemonNode *root, OwnerNode *owner, const char *first,
+                         const char *second, FILE *out) {
+
+    int id1, id2;
+    if (!commandInt(first, &id1) || !commandInt(second, &id2)) {
+        fprintf(out, "ERR usage: FIGHT <owner> <id> <id>\n");
+        return;
+    }
+    const PokemonData *pokemon1;
+    const PokemonData *pokemon2;
+    if (owner) {
+        pokemon1 = ownerFindPokemon(owner, id1);
+        pokemon2 = ownerFindPokemon(owner, id2);
+    } else {
+        PokemonNode *node1 = searchPokemonBST(root, id1);
+        PokemonNode *node2 = searchPokemonBST(root, id2);
+        pokemon1 = node1 ? node1->data : NULL;
+        pokemon2 = node2 ? node2->data : NULL;
+    }
+    if (!pokemon1 || !pokemon2) {
+        fprintf(out, "ERR one or both Pokemon IDs not found\n");
+        return;
+    }
+
+    float strength1 = pokemonCalcStregth(pokemon1);
+    float strength2 = pokemonCalcStregth(pokemon2);
+    fprintf(out, "OK\nPokemon 1: %s (Score = %f)\nPokemon 2: %s (Score = %f)\n",
+            pokemon1->name, strength1, pokemon2->name, strength2);
+    if (strength1 > strength2)
+        fprintf(out, "%s wins!\n", pokemon1->name);
+    else if (strength1 < strength2)
+        fprintf(out, "%s wins!\n", pokemon2->name);
+    else
+        fprintf(out, "It's a tie!\n");
+}
+
+static void commandFind(PokemonNode *root, const char *query, FILE *out) {
+
+    if (!query) {
+        fprintf(out, "ERR usage: FIND <owner> <name-or-prefix>\n");
+        return;
+    }
+
+    int ids[POKEDEX_SIZE];
+    int total = searchSpeciesByPrefix(query, ids, POKEDEX_SIZE);
+    if (total == 0)
+        total = fuzzySearchSpecies(query, 2, ids, POKEDEX_SIZE);
+    if (total > POKEDEX_SIZE)
+        total = POKEDEX_SIZE;
+
+    fprintf(out, "OK\n");
+    for (int i = 0; i < total; i++) {
+        PokemonNode *node = searchPokemonBST(root, ids[i]);
+        if (node)
+            writePokemonNode(out, node);
+    }
+}
+
+static void commandHelp(FILE *out) {
+
+    fprintf(out, "OK\n"
+                 "NEW <owner> <starter 1-3>\n"
+                 "LIST\n"
+                 "DELETE <owner>\n"
+                 "MERGE <owner> <owner-to-remove>\n"
+                 "MERGEMANY <owner> <owner-to-remove>...\n"
+                 "SORT\n"
+                 "STATS\n"
+                 "ADD <owner> <id>\n"
+                 "BULK <owner> <id>...\n"
+                 "RELEASE <owner> <id>\n"
+                 "EVOLVE <owner> <id>\n"
+                 "EVOLVEALL <owner>\n"
+                 "FINAL <owner>\n"
+                 "FIGHT <owner> <id> <id>\n"
+                 "FIND <owner> <name-or-prefix>\n"
+                 "SHOW <owner> BFS|PRE|IN|POST|ALPHA\n"
+                 "QUIT\n"
+                 "SHUTDOWN\n");
+}
+
+// Commands that change one owner's Pokedex, and those that only read its published copy
+static const char *const ownerCommands[] = {
+    "DELETE", "ADD", "BULK", "RELEASE", "EVOLVE", "EVOLVEALL", "FINAL",
+};
+static const char *const viewCommands[] = {
+    "FIGHT", "FIND", "SHOW",
+};
+
+static int isCommandIn(const char *cmd, const char *const *table, size_t size) {
+
+    for (size_t i = 0; i < size; i++) {
+        if (compareNamesNoCase(cmd, table[i]) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+// No locks: the view stays valid until donePublishedRing
+static void commandOnView(const PokedexView *view, char **tokens, FILE *out) {
+
+    const char *cmd = tokens[0];
+    if (compareNamesNoCase(cmd, "FIGHT") == 0)
+        commandFight(view->root, NULL, tokens[2], tokens[3], out);
+    else if (compareNamesNoCase(cmd, "FIND") == 0)
+        commandFind(view->root, tokens[2], out);
+    else
+        commandShow(view->root, tokens[2], out);
+}
+
+// Caller holds the ring read lock and owner->lock; readers see the result once published
+static void commandOnOwner(OwnerNode *owner, char **tokens, int count, FILE *out) {
+
+    const char *cmd = tokens[0];
+    int id = 0;
+    if (compareNamesNoCase(cmd, "FIGHT") == 0) {
+        // Only a lookup, but it runs on (and may reshape) the owner's engine copy
+        commandFight(NULL, owner, tokens[2], tokens[3], out);
+        return;
+    }
+    if (compareNamesNoCase(cmd, "DELETE") == 0) {
+        clearOwnerPokedex(owner);
+        fprintf(out, "OK\n");
+    } else if (compareNamesNoCase(cmd, "ADD") == 0) {
+        if (!commandInt(tokens[2], &id) || id < 1 || id > POKEDEX_SIZE)
+            fprintf(out, "ERR invalid ID\n");
+        else if (addPokemonByID(owner, id) < 0)
+            fprintf(out, "ERR out of memory\n");
+        else
+            fprintf(out, "OK\n");
+    } else if (compareNamesNoCase(cmd, "BULK") == 0) {
+        int ids[SERVER_TOKEN_MAX];
+        int idCount = 0;
+        for (int i = 2; i < count; i++) {
+            if (commandInt(tokens[i], &id) && id >= 1 && id <= POKEDEX_SIZE)
+                ids[idCount++] = id;
+        }
+        fprintf(out, "OK\nAdded %d Pokemon.\n", bulkAddToOwner(owner, ids, idCount));
+    } else if (compareNamesNoCase(cmd, "RELEASE") == 0) {
+        if (!commandInt(tokens[2], &id) || !releasePokemonByID(owner, id))
+            fprintf(out, "ERR no such Pokemon\n");
+        else
+            fprintf(out, "OK\n");
+    } else if (compareNamesNoCase(cmd, "EVOLVE") == 0) {
+        int result = commandInt(tokens[2], &id) ? evolvePokemonByID(owner, id) : 0;
+        if (result == 0)
+            fprintf(out, "ERR no such Pokemon\n");
+        else if (result < 0)
+            fprintf(out, "ERR cannot evolve\n");
+        else
+            fprintf(out, "OK\nPokemon evolved from %s (ID %d) to %s (ID %d).\n",
+                    pokedex[id - 1].name, id, pokedex[id].name, id + 1);
+    } else {
+        fprintf(out, "OK\n");
+        evolveOwnerPokedex(owner, compareNamesNoCase(cmd, "FINAL") == 0, out);
+    }
+    publishOwnerView(owner);
+}
+
+static void commandNew(const char *name, const char *starterToken, FILE *out) {
+
+    int starter;
+    if (!name || !commandInt(starterToken, &starter) || starter < 1 || starter > 3) {
+        fprintf(out, "ERR usage: NEW <owner> <starter 1-3>\n");
+        return;
+    }
+
+    size_t nameSize = strlen(name) + 1;
+    char *copy = malloc(nameSize);
+    PokemonNode *starterNode = createPokemonNode(&pokedex[3 * (starter - 1)]);
+    if (!copy || !starterNode) {
+        free(copy);
+        freePokemonTree(starterNode);
+        fprintf(out, "ERR out of memory\n");
+        return;
+    }
+    memcpy(copy, name, nameSize);
+
+    // The duplicate check and the link must be one step, so both happen under the write lock
+    pthread_rwlock_wrlock(&ownerRingLock);
+    OwnerNode *owner = findOwnerByName(name) ? NULL : createOwner(copy, starterNode);
+    if (owner) {
+        linkOwnerInCircularList(owner);
+        publishOwnerView(owner);
+    }
+    pthread_rwlock_unlock(&ownerRingLock);
+
+    if (owner) {
+        fprintf(out, "OK\n");
+        return;
+    }
+    free(copy);
+    freePokemonTree(starterNode);
+    fprintf(out, "ERR owner already exists\n");
+}
+
+/*
+ * Unlink and free owners marked merged. Caller holds the ring write lock. Any writer may
+ * get here first, which is why the merge itself keeps no pointer to its victim afterwards.
+ */
+static void reapMergedOwners(void) {
+
+    for (int s = 0; s < OWNER_SHARDS; s++) {
+        OwnerNode *cur = ownerShards[s].head;
+        for (size_t left = ownerShards[s].count; left > 0; left--) {
+            OwnerNode *next = cur->next;
+            if (__atomic_load_n(&cur->merged, __ATOMIC_ACQUIRE)) {
+                removeOwnerFromCircularList(cur);
+                freeOwnerNode(cur);
+            }
+            cur = next;
+        }
+    }
+}
+
+/*
+ * MERGE copies under the two owner locks with the ring only read-locked, so merges of
+ * other owners run alongside. The victim is then marked merged (lookups skip it) and
+ * unlinked later under the write lock, once nobody can still be holding it.
+ */
+static void commandMerge(const char *nameIn, const char *nameOut, FILE *out) {
+
+    pthread_rwlock_rdlock(&ownerRingLock);
+    OwnerNode *ownerIn = commandOwner(nameIn, out);
+    OwnerNode *ownerOut = ownerIn ? commandOwner(nameOut, out) : NULL;
+    if (!ownerIn || !ownerOut) {
+        pthread_rwlock_unlock(&ownerRingLock);
+        return;
+    }
+    if (ownerIn == ownerOut) {
+        pthread_rwlock_unlock(&ownerRingLock);
+        fprintf(out, "ERR cannot merge an owner with itself\n");
+        return;
+    }
+
+    lockOwnerPair(ownerIn, ownerOut);
+    // Another merge may have claimed either owner between the lookup and the lock
+    int claimed = __atomic_load_n(&ownerIn->merged, __ATOMIC_ACQUIRE) ||
+                  __atomic_load_n(&ownerOut->merged, __ATOMIC_ACQUIRE);
+    if (!claimed) {
+        mergePokedexInto(ownerIn, ownerOut);
+        __atomic_store_n(&ownerOut->merged, 1, __ATOMIC_RELEASE);
+        publishOwnerView(ownerIn);
+        publishOwnerRing();
+    }
+    pthread_mutex_unlock(&ownerOut->lock);
+    pthread_mutex_unlock(&ownerIn->lock);
+    pthread_rwlock_unlock(&ownerRingLock);
+
+    if (claimed) {
+        fprintf(out, "ERR no such owner\n");
+        return;
+    }
+
+    pthread_rwlock_wrlock(&ownerRingLock);
+    reapMergedOwners();
+    pthread_rwlock_unlock(&ownerRingLock);
+    fprintf(out, "OK\n");
+}
+
+// MERGE for many owners at once: one lock round, one merge pass, one reap
+static void commandMergeMany(char **tokens, int count, FILE *out) {
+
+    if (count < 3) {
+        fprintf(out, "ERR usage: MERGEMANY <owner> <owner-to-remove>...\n");
+        return;
+    }
+
+    int total = count - 1;
+    OwnerNode *found[SERVER_TOKEN_MAX];
+    OwnerNode *locked[SERVER_TOKEN_MAX];
+    pthread_rwlock_rdlock(&ownerRingLock);
+    for (int i = 0; i < total; i++) {
+        found[i] = commandOwner(tokens[i + 1], out);
+        if (!found[i]) {
+            pthread_rwlock_unlock(&ownerRingLock);
+            return;
+        }
+        for (int j = 0; j < i; j++) {
+            if (found[j] == found[i]) {
+                pthread_rwlock_unlock(&ownerRingLock);
+                fprintf(out, "ERR owner named twice\n");
+                return;
+            }
+        }
+    }
+
+    memcpy(locked, found, (size_t)total * sizeof(OwnerNode *));
+    lockOwnerSet(locked, total);
+    int claimed = 0;
+    for (int i = 0; i < total; i++)
+        claimed |= __atomic_load_n(&found[i]->merged, __ATOMIC_ACQUIRE);
+    int result = -1;
+    if (!claimed) {
+        result = mergePokedexesInto(found[0], found + 1, total - 1);
+        if (result >= 0) {
+            for (int i = 1; i < total; i++)
+                __atomic_store_n(&found[i]->merged, 1, __ATOMIC_RELEASE);
+            publishOwnerView(found[0]);
+            publishOwnerRing();
+        }
+    }
+    for (int i = total - 1; i >= 0; i--)
+        pthread_mutex_unlock(&locked[i]->lock);
+    pthread_rwlock_unlock(&ownerRingLock);
+
+    if (claimed) {
+        fprintf(out, "ERR no such owner\n");
+        return;
+    }
+    if (result < 0) {
+        fprintf(out, "ERR out of memory\n");
+        return;
+    }
+
+    pthread_rwlock_wrlock(&ownerRingLock);
+    reapMergedOwners();
+    pthread_rwlock_unlock(&ownerRingLock);
+    fprintf(out, "OK\nMerged %d owners, %d Pokemon.\n", total - 1, result);
+}
+
+// No locks: the statistics cover the published copies, which stay valid until donePublishedRing
+static void commandStats(FILE *out) {
+
+    const OwnerRingView *ring = readPublishedRing();
+    int count = ring ? ring->count : 0;
+    PokemonNode **roots = malloc((size_t)(count > 0 ? count : 1) * sizeof(PokemonNode *));
+    if (!roots) {
+        donePublishedRing();
+        fprintf(out, "ERR out of memory\n");
+        return;
+    }
+    for (int i = 0; i < count; i++)
+        roots[i] = ringViewAt(ring, i)->root;
+
+    PokedexStats stats;
+    collectPokedexStats(roots, count, &stats);
+    donePublishedRing();
+    free(roots);
+    fprintf(out, "OK\n");
+    writePokedexStats(out, &stats, (size_t)count);
+}
+
+/**
+ * @brief Run one text command against the owner registry, writing the reply to out.
+ * @param line command line (modified: it is split into tokens)
+ * @param out stream receiving "OK"/"ERR ..." and any listing
+ * @return COMMAND_QUIT / COMMAND_SHUTDOWN for those commands, else COMMAND_OK
+ * Why we made it: Server clients speak the main menu and Pokedex menu as one-line commands.
+ */
+CommandResult executeCommand(char *line, FILE *out) {
+
+    char *save = NULL;
+    char *tokens[SERVER_TOKEN_MAX];
+    int count = 0;
+    char *tok = strtok_r(line, " \t\r", &save);
+    for (; tok && count < SERVER_TOKEN_MAX; tok = strtok_r(NULL, " \t\r", &save))
+        tokens[count++] = tok;
+    for (int i = count; i < 4; i++)
+        tokens[i] = NULL;
+
+    if (count == 0) {
+        fprintf(out, "ERR empty command\n");
+        return COMMAND_OK;
+    }
+    // Tokens left over would be silently dropped: refuse the whole line instead
+    if (tok) {
+        if (compareNamesNoCase(tokens[0], "MERGEMANY") == 0)
+            fprintf(out, "ERR too many owners\n");
+        else
+            fprintf(out, "ERR too many arguments\n");
+        return COMMAND_OK;
+    }
+
+    const char *cmd = tokens[0];
+    if (compareNamesNoCase(cmd, "QUIT") == 0) {
+        fprintf(out, "OK\n");
+        return COMMAND_QUIT;
+    }
+    if (compareNamesNoCase(cmd, "SHUTDOWN") == 0) {
+        fprintf(out, "OK\n");
+        return COMMAND_SHUTDOWN;
+    }
+    if (compareNamesNoCase(cmd, "HELP") == 0) {
+        commandHelp(out);
+        return COMMAND_OK;
+    }
+    if (compareNamesNoCase(cmd, "LIST") == 0) {
+        const OwnerRingView *ring = readPublishedRing();
+        fprintf(out, "OK\n");
+        for (int i = 0; ring && i < ring->count; i++)
+            fprintf(out, "%d. %s\n", i + 1, ring->owners[i]->ownerName);
+        donePublishedRing();
+        return COMMAND_OK;
+    }
+    if (compareNamesNoCase(cmd, "STATS") == 0) {
+        commandStats(out);
+        return COMMAND_OK;
+    }
+    if (compareNamesNoCase(cmd, "SORT") == 0) {
+        pthread_rwlock_wrlock(&ownerRingLock);
+        reapMergedOwners();
+        sortOwners();
+        publishOwnerRing();
+        pthread_rwlock_unlock(&ownerRingLock);
+        fprintf(out, "OK\n");
+        return COMMAND_OK;
+    }
+    if (compareNamesNoCase(cmd, "NEW") == 0) {
+        commandNew(tokens[1], tokens[2], out);
+        return COMMAND_OK;
+    }
+    if (compareNamesNoCase(cmd, "MERGE") == 0) {
+        commandMerge(tokens[1], tokens[2], out);
+        return COMMAND_OK;
+    }
+    if (compareNamesNoCase(cmd, "MERGEMANY") == 0) {
+        commandMergeMany(tokens, count, out);
+        return COMMAND_OK;
+    }
+    // With --engine, FIGHT looks up through the owner's engine copy under the owner lock
+    int engineFight = lookupEngine && compareNamesNoCase(cmd, "FIGHT") == 0;
+    int onView = isCommandIn(cmd, viewCommands, sizeof(viewCommands) / sizeof(viewCommands[0]));
+    int onOwner = isCommandIn(cmd, ownerCommands, sizeof(ownerCommands) / sizeof(ownerCommands[0]));
+    if (onView && !engineFight) {
+        const PokedexView *view = findPublishedView(readPublishedRing(), tokens[1]);
+        if (view)
+            commandOnView(view, tokens, out);
+        else
+            fprintf(out, "ERR no such owner\n");
+        donePublishedRing();
+        return COMMAND_OK;
+    }
+    if (!onOwner && !engineFight) {
+        fprintf(out, "ERR unknown command (try HELP)\n");
+        return COMMAND_OK;
+    }
+
+    // Everything else works on one owner's Pokedex: share the ring, hold that owner
+    pthread_rwlock_rdlock(&ownerRingLock);
+    OwnerNode *owner = commandOwner(tokens[1], out);
+    if (owner) {
+        pthread_mutex_lock(&owner->lock);
+        // A merge may have folded this owner away while we waited for its lock
+        if (__atomic_load_n(&owner->merged, __ATOMIC_ACQUIRE))
+            fprintf(out, "ERR no such owner\n");
+        else
+            commandOnOwner(owner, tokens, count, out);
+        pthread_mutex_unlock(&owner->lock);
+    }
+    pthread_rwlock_unlock(&ownerRingLock);
+    return COMMAND_OK;
+}
+
+// Write everything, waiting out a full socket buffer; errors mean the client is gone
+static void serverSendAll(int fd, const char *data, size_t len) {
+
+    while (len > 0) {
+        ssize_t sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent > 0) {
+            data += sent;
+            len -= (size_t)sent;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct pollfd pfd = {fd, POLLOUT, 0};
+            poll(&pfd, 1, -1);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return;
+        }
+    }
+}
+
+static void *serverWorker(void *arg) {
+
+    Server *srv = arg;
+    for (;;) {
+        pthread_mutex_lock(&srv->queueLock);
+        while (!srv->jobHead && !srv->stopping)
+            pthread_cond_wait(&srv->queueReady, &srv->queueLock);
+        ServerClient *client = srv->jobHead;
+        if (!client) {
+            pthread_mutex_unlock(&srv->queueLock);
+            return NULL;
+        }
+        srv->jobHead = client->nextJob;
+        if (!srv->jobHead)
+            srv->jobTail = NULL;
+        pthread_mutex_unlock(&srv->queueLock);
+
+        // The reply is built in memory, then sent once every lock is released
+        char *reply = NULL;
+        size_t replyLen = 0;
+        ServerDone done = {client, COMMAND_OK};
+        FILE *out = open_memstream(&reply, &replyLen);
+        if (out) {
+            done.result = executeCommand(client->line, out);
+            fputs(".\n", out);
+            fclose(out);
+            serverSendAll(client->fd, reply, replyLen);
+            free(reply);
+        } else {
+            serverSendAll(client->fd, "ERR out of memory\n.\n", 20);
+        }
+        free(client->line);
+        client->line = NULL;
+
+        // Hand the client back to the event loop (pipe writes this small are atomic)
+        while (write(srv->donePipe[1], &done, sizeof(done)) < 0 && errno == EINTR)
+            ;
+    }
+}
+
+static void serverCloseClient(Server *srv, ServerClient *client) {
+
+    if (client->prev)
+        client->prev->next = client->next;
+    else
+        srv->clients = client->next;
+    if (client->next)
+        client->next->prev = client->prev;
+    close(client->fd);
+    free(client->in);
+    free(client->line);
+    free(client);
+}
+
+// Queue the next buffered command if the client is idle; 0 if the client must be dropped
+static int serverDispatch(Server *srv, ServerClient *client) {
+
+    if (client->busy)
+        return 1;
+
+    char *newline = client->inLen ? memchr(client->in, '\n', client->inLen) : NULL;
+    if (!newline) {
+        if (client->inLen > SERVER_MAX_LINE) {
+            serverSendAll(client->fd, "ERR line too long\n.\n", 20);
+            return 0;
+        }
+        return 1;
+    }
+
+    size_t lineLen = (size_t)(newline - client->in);
+    client->line = malloc(lineLen + 1);
+    if (!client->line)
+        return 0;
+    memcpy(client->line, client->in, lineLen);
+    client->line[lineLen] = '\0';
+    client->inLen -= lineLen + 1;
+    memmove(client->in, newline + 1, client->inLen);
+
+    // One job in flight per client keeps replies in request order
+    client->busy = 1;
+    epoll_ctl(srv->epollFd, EPOLL_CTL_DEL, client->fd, NULL);
+    client->nextJob = NULL;
+    pthread_mutex_lock(&srv->queueLock);
+    if (srv->jobTail)
+        srv->jobTail->nextJob = client;
+    else
+        srv->jobHead = client;
+    srv->jobTail = client;
+    pthread_cond_signal(&srv->queueReady);
+    pthread_mutex_unlock(&srv->queueLock);
+    return 1;
+}
+
+// Drain the socket into the client's buffer; 0 once the peer is gone
+static int serverRead(ServerClient *client) {
+
+    for (;;) {
+        if (client->inCap - client->inLen < SERVER_READ_CHUNK) {
+            size_t cap = client->inCap ? client->inCap * 2 : SERVER_READ_CHUNK * 2;
+            char *grown = realloc(client->in, cap);
+            if (!grown)
+                return 0;
+            client->in = grown;
+            client->inCap = cap;
+        }
+        ssize_t got = read(client->fd, client->in + client->inLen, client->inCap - client->inLen);
+        if (got > 0) {
+            client->inLen += (size_t)got;
+            if (client->inLen > SERVER_MAX_LINE)
+                return 1;
+            continue;
+        }
+        if (got < 0 && errno == EINTR)
+            continue;
+        return got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+static void serverAccept(Server *srv) {
+
+    for (;;) {
+        int fd = accept4(srv->listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        ServerClient *client = calloc(1, sizeof(ServerClient));
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = client;
+        if (!client || epoll_ctl(srv->epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            free(client);
+            close(fd);
+            continue;
+        }
+        client->fd = fd;
+        client->next = srv->clients;
+        if (srv->clients)
+            srv->clients->prev = client;
+        srv->clients = client;
+    }
+}
+
+static void serverJobsDone(Server *srv) {
+
+    ServerDone done;
+    while (read(srv->donePipe[0], &done, sizeof(done)) == (ssize_t)sizeof(done)) {
+        ServerClient *client = done.client;
+        client->busy = 0;
+        if (done.result == COMMAND_SHUTDOWN) {
+            // Workers read the flag under the queue lock
+            pthread_mutex_lock(&srv->queueLock);
+            srv->stopping = 1;
+            pthread_mutex_unlock(&srv->queueLock);
+        }
+        if (done.result != COMMAND_OK) {
+            serverCloseClient(srv, client);
+            continue;
+        }
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = client;
+        if (epoll_ctl(srv->epollFd, EPOLL_CTL_ADD, client->fd, &ev) < 0 ||
+            !serverDispatch(srv, client))
+            serverCloseClient(srv, client);
+    }
+}
+
+static void serverOnSignal(int sig) {
+
+    (void)sig;
+    serverStopRequested = 1;
+}
+
+/**
+ * @brief Serve the owner registry to many clients over a Unix domain socket.
+ * @param path filesystem path of the socket (replaced if it exists)
+ * @return process exit status
+ * Why we made it: One resident process replaces a process per user plus offline merging.
+ */
+int runServer(const char *path) {
+
+    Server srv;
+    memset(&srv, 0, sizeof(srv));
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long.\n");
+        return 1;
+    }
+    strcpy(addr.sun_path, path);
+
+    srv.listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (srv.listenFd < 0) {
+        perror("socket");
+        return 1;
+    }
+    unlink(path);
+    if (bind(srv.listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(srv.listenFd, SOMAXCONN) < 0) {
+        perror(path);
+        close(srv.listenFd);
+        return 1;
+    }
+
+    srv.epollFd = epoll_create1(EPOLL_CLOEXEC);
+    // Only the loop's end of the pipe is non-blocking; workers may wait to report
+    if (srv.epollFd < 0 || pipe2(srv.donePipe, O_CLOEXEC) < 0 ||
+        fcntl(srv.donePipe[0], F_SETFL, O_NONBLOCK) < 0) {
+        perror("epoll");
+        close(srv.listenFd);
+        return 1;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = &srv.listenFd;
+    epoll_ctl(srv.epollFd, EPOLL_CTL_ADD, srv.listenFd, &ev);
+    ev.data.ptr = srv.donePipe;
+    epoll_ctl(srv.epollFd, EPOLL_CTL_ADD, srv.donePipe[0], &ev);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = serverOnSignal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    pthread_mutex_init(&srv.queueLock, NULL);
+    pthread_cond_init(&srv.queueReady, NULL);
+    int started = 0;
+    while (started < SERVER_WORKERS &&
+           pthread_create(&srv.workers[started], NULL, serverWorker, &srv) == 0)
+        started++;
+
+    printf("Serving on %s with %d workers.\n", path, started);
+    fflush(stdout);
+
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    while (started > 0 && !srv.stopping && !serverStopRequested) {
+        int n = epoll_wait(srv.epollFd, events, SERVER_MAX_EVENTS, -1);
+        for (int i = 0; i < n; i++) {
+            void *tag = events[i].data.ptr;
+            if (tag == &srv.listenFd) {
+                serverAccept(&srv);
+            } else if (tag == srv.donePipe) {
+                serverJobsDone(&srv);
+            } else {
+                ServerClient *client = tag;
+                int alive = serverRead(client);
+                if (!serverDispatch(&srv, client) || (!alive && !client->busy))
+                    serverCloseClient(&srv, client);
+            }
+        }
+    }
+
+    // Workers finish whatever is queued, then exit
+    pthread_mutex_lock(&srv.queueLock);
+    srv.stopping = 1;
+    pthread_cond_broadcast(&srv.queueReady);
+    pthread_mutex_unlock(&srv.queueLock);
+    for (int i = 0; i < started; i++)
+        pthread_join(srv.workers[i], NULL);
+
+    while (srv.clients)
+        serverCloseClient(&srv, srv.clients);
+    close(srv.donePipe[0]);
+    close(srv.donePipe[1]);
+    close(srv.epollFd);
+    close(srv.listenFd);
+    unlink(path);
+    pthread_cond_destroy(&srv.queueReady);
+    pthread_mutex_destroy(&srv.queueLock);
+    releasePublishedViews();
+    freeAllOwners();
+    return 0;
+}
+
+// Connect to a server socket; -1 (with a message) on failure
+static int clientConnect(const char *path) {
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long.\n");
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror(path);
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/*
+ * Send one command (newline-terminated) and read its reply up to the "." line, copying
+ * reply lines to echo if given. Returns 1 for OK, 0 for ERR, -1 if the server went away.
+ */
+static int clientRoundTrip(int fd, FILE *replies, const char *cmd, size_t len,
+                           char **reply, size_t *replyCap, FILE *echo) {
+
+    serverSendAll(fd, cmd, len);
+
+    int status = -1;
+    ssize_t got;
+    while ((got = getline(reply, replyCap, replies)) > 0 && strcmp(*reply, ".\n") != 0) {
+        if (status < 0)
+            status = strncmp(*reply, "OK", 2) == 0;
+        if (echo)
+            fputs(*reply, echo);
+    }
+    return got > 0 ? status : -1;
+}
+
+/**
+ * @brief Send each stdin line to the server as a command and print the replies.
+ * @param path filesystem path of the server's socket
+ * @return process exit status
+ */
+int runClient(const char *path) {
+
+    int fd = clientConnect(path);
+    if (fd < 0)
+        return 1;
+    FILE *replies = fdopen(fd, "r");
+    if (!replies) {
+        close(fd);
+        return 1;
+    }
+
+    char *line = NULL;
+    size_t lineCap = 0;
+    char *reply = NULL;
+    size_t replyCap = 0;
+    ssize_t len;
+    int status = 0;
+    while ((len = getline(&line, &lineCap, stdin)) > 0) {
+        if (line[len - 1] != '\n') {
+            // getline leaves room for the terminator, but not always for a newline
+            char *grown = realloc(line, (size_t)len + 2);
+            if (!grown)
+                break;
+            line = grown;
+            line[len++] = '\n';
+            line[len] = '\0';
+        }
+        if (clientRoundTrip(fd, replies, line, (size_t)len, &reply, &replyCap, stdout) < 0) {
+            status = 1;
+            break;
+        }
+    }
+
+    free(line);
+    free(reply);
+    fclose(replies);
+    return status;
+}
+
+#define STRESS_DEFAULT_CLIENTS 8
+#define STRESS_DEFAULT_REQUESTS 20000
+#define STRESS_TEMP_OWNERS 4
+
+typedef struct {
+    const char *path;
+    int index;
+    int clients;
+    int requests;
+    int sent;
+    int errors;
+    int failed;
+} StressClient;
+
+/*
+ * Each stress client owns "S<i>" but works on random owners, so requests on different
+ * owners overlap and requests on the same owner contend. Temporary owners "M<i>_<k>"
+ * are merged into random targets, sometimes into another client's temporary owner, so
+ * merges of one pair in both directions race each other.
+ */
+static void *stressClientMain(void *arg) {
+
+    StressClient *sc = arg;
+    int fd = clientConnect(sc->path);
+    FILE *replies = fd >= 0 ? fdopen(fd, "r") : NULL;
+    if (!replies) {
+        if (fd >= 0)
+            close(fd);
+        sc->failed = 1;
+        return NULL;
+    }
+
+    unsigned int seed = 2654435761u * (unsigned int)(sc->index + 1);
+    char cmd[256];
+    char *reply = NULL;
+    size_t replyCap = 0;
+    int tempSerial = 0;
+
+    snprintf(cmd, sizeof(cmd), "NEW S%d %d\n", sc->index, sc->index % 3 + 1);
+    for (int n = 0; n <= sc->requests; n++) {
+        if (n > 0) {
+            int target = rand_r(&seed) % sc->clients;
+            int id = rand_r(&seed) % POKEDEX_SIZE + 1;
+            int temp = rand_r(&seed) % STRESS_TEMP_OWNERS;
+            switch (rand_r(&seed) % 13) {
+            case 0:
+            case 1:
+                snprintf(cmd, sizeof(cmd), "ADD S%d %d\n", target, id);
+                break;
+            case 2:
+                snprintf(cmd, sizeof(cmd), "RELEASE S%d %d\n", target, id);
+                break;
+            case 3:
+                snprintf(cmd, sizeof(cmd), "SHOW S%d %s\n", target, (id & 1) ? "IN" : "BFS");
+                break;
+            case 4:
+                snprintf(cmd, sizeof(cmd), "EVOLVE S%d %d\n", target, id);
+                break;
+            case 5:
+                snprintf(cmd, sizeof(cmd), "FIGHT S%d %d %d\n", target, id, rand_r(&seed) % POKEDEX_SIZE + 1);
+                break;
+            case 6:
+                snprintf(cmd, sizeof(cmd), (n % 20 == 0) ? "STATS\n" : "LIST\n");
+                break;
+            case 7:
+                snprintf(cmd, sizeof(cmd), (n % 50 == 0) ? "SORT\n" : "FIND S%d ch\n", target);
+                break;
+            case 8:
+                snprintf(cmd, sizeof(cmd), "NEW M%d_%d %d\n", sc->index, tempSerial++ % STRESS_TEMP_OWNERS, id % 3 + 1);
+                break;
+            case 9:
+                snprintf(cmd, sizeof(cmd), "BULK M%d_%d %d %d %d\n", sc->index, temp, id,
+                         rand_r(&seed) % POKEDEX_SIZE + 1, rand_r(&seed) % POKEDEX_SIZE + 1);
+                break;
+            case 10:
+                snprintf(cmd, sizeof(cmd), "MERGE S%d M%d_%d\n", target, sc->index, temp);
+                break;
+            case 11:
+                snprintf(cmd, sizeof(cmd), "MERGE M%d_%d M%d_%d\n", sc->index, temp, target,
+                         rand_r(&seed) % STRESS_TEMP_OWNERS);
+                break;
+            default:
+                snprintf(cmd, sizeof(cmd), "MERGEMANY S%d M%d_%d M%d_%d M%d_%d\n", target, sc->index,
+                         temp, target, (temp + 1) % STRESS_TEMP_OWNERS, sc->index,
+                         (temp + 2) % STRESS_TEMP_OWNERS);
+                break;
+            }
+        }
+
+        int status = clientRoundTrip(fd, replies, cmd, strlen(cmd), &reply, &replyCap, NULL);
+        if (status < 0) {
+            sc->failed = 1;
+            break;
+        }
+        sc->sent++;
+        if (status == 0)
+            sc->errors++;
+    }
+
+    free(reply);
+    fclose(replies);
+    return NULL;
+}
+
+/**
+ * @brief Hammer a running server with concurrent clients and report throughput.
+ * @param path filesystem path of the server's socket
+ * @param clients number of concurrent connections
+ * @param requests requests per connection
+ * @return process exit status (non-zero if any connection broke)
+ * Why we made it: Run against a ThreadSanitizer build of the server to check the locking.
+ */
+int runStress(const char *path, int clients, int requests) {
+
+    if (clients < 1)
+        clients = STRESS_DEFAULT_CLIENTS;
+    if (requests < 1)
+        requests = STRESS_DEFAULT_REQUESTS;
+
+    StressClient *scs = calloc((size_t)clients, sizeof(StressClient));
+    pthread_t *threads = calloc((size_t)clients, sizeof(pthread_t));
+    if (!scs || !threads) {
+        free(scs);
+        free(threads);
+        return 1;
+    }
+
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    int started = 0;
+    for (int i = 0; i < clients; i++) {
+        scs[i].path = path;
+        scs[i].index = i;
+        scs[i].clients = clients;
+        scs[i].requests = requests;
+        if (pthread_create(&threads[i], NULL, stressClientMain, &scs[i]) != 0)
+            break;
+        started++;
+    }
+
+    int sent = 0, errors = 0, failed = started < clients;
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+        sent += scs[i].sent;
+        errors += scs[i].errors;
+        failed |= scs[i].failed;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (double)(end.tv_sec - begin.tv_sec) + (double)(end.tv_nsec - begin.tv_nsec) / 1e9;
+    printf("%d clients, %d requests in %.2fs (%.0f requests/s), %d ERR replies%s\n",
+           started, sent, seconds, seconds > 0 ? sent / seconds : 0.0, errors,
+           failed ? ", some connections failed" : "");
+
+    free(scs);
+    free(threads);
+    return failed;
+}
+
+/* ------------------------------------------------------------
+   23) Published Views (Read-Copy-Update)
+   ------------------------------------------------------------ */
+
+#define EPOCH_READER_SLOTS 64
+
+/*
+ * Epoch-based reclamation. A reader copies globalEpoch into its slot before loading
+ * publishedRing and clears the slot when done. A writer bumps the epoch only once every
+ * busy slot shows the current one, so something retired in epoch E can't be held by
+ * any reader once the epoch reaches E + 2. Threads beyond the slot count read under
+ * publishLock instead.
+ */
+static pthread_mutex_t publishLock = PTHREAD_MUTEX_INITIALIZER;
+static OwnerRingView *publishedRing = NULL;
+static unsigned long globalEpoch = 1;
+static unsigned long readerEpochs[EPOCH_READER_SLOTS]; // 0 = not reading
+static int readerSlotTaken[EPOCH_READER_SLOTS];
+static __thread int readerSlot = -1;
+static __thread int readerHoldsPublishLock = 0;
+
+// Guarded by publishLock
+static PokedexView *limboViews = NULL;    // Replaced; freed after the grace period
+static ViewSlot *limboSlots = NULL;       // Out of the ring; freed (with their views) likewise
+static OwnerRingView *limboRings = NULL;
+
+// Pre-order copy into consecutive slots of one block; returns the copy of node
+static PokemonNode *copyTreeIntoBlock(const PokemonNode *node, PokemonNode *block, int *used) {
+
+    if (!node)
+        return NULL;
+    PokemonNode *copy = &block[(*used)++];
+    copy->data = node->data;
+    copy->dead = node->dead;
+    copy->refs = 1;
+    copy->left = copyTreeIntoBlock(node->left, block, used);
+    copy->right = copyTreeIntoBlock(node->right, block, used);
+    return copy;
+}
+
+/*
+ * One malloc holds the view and its nodes, so publishing costs a single allocation
+ * (not one per node through the shared arena lock) and retiring one free().
+ */
+static PokedexView *createPokedexView(OwnerNode *owner) {
+
+    int total = 0, dead = 0;
+    countTreeNodes(owner->pokedexRoot, &total, &dead);
+    if (owner->pokedexRoot && total == 0)
+        return NULL; // The count itself ran out of memory
+    PokedexView *view = malloc(sizeof(PokedexView) + (size_t)total * sizeof(PokemonNode));
+    if (!view)
+        return NULL;
+
+    int used = 0;
+    view->root = copyTreeIntoBlock(owner->pokedexRoot, (PokemonNode *)(view + 1), &used);
+    view->next = NULL;
+    view->retiredAt = 0;
+    return view;
+}
+
+// The slot and its name share one block
+static ViewSlot *createViewSlot(OwnerNode *owner) {
+
+    size_t nameSize = strlen(owner->ownerName) + 1;
+    ViewSlot *slot = malloc(sizeof(ViewSlot) + nameSize);
+    if (!slot)
+        return NULL;
+    slot->view = NULL;
+    slot->ownerName = (char *)(slot + 1);
+    memcpy(slot->ownerName, owner->ownerName, nameSize);
+    slot->nameHash = owner->nameHash;
+    slot->next = NULL;
+    slot->retiredAt = 0;
+    return slot;
+}
+
+static void freeViewSlot(ViewSlot *slot) {
+
+    free(slot->view);
+    free(slot);
+}
+
+// Caller holds publishLock
+static void reclaimRetired(void) {
+
+    unsigned long epoch = __atomic_load_n(&globalEpoch, __ATOMIC_SEQ_CST);
+    int quiet = 1;
+    for (int i = 0; i < EPOCH_READER_SLOTS && quiet; i++) {
+        unsigned long seen = __atomic_load_n(&readerEpochs[i], __ATOMIC_SEQ_CST);
+        quiet = (seen == 0 || seen == epoch);
+    }
+    if (quiet)
+        __atomic_store_n(&globalEpoch, ++epoch, __ATOMIC_SEQ_CST);
+
+    PokedexView **view = &limboViews;
+    while (*view) {
+        if ((*view)->retiredAt + 2 <= epoch) {
+            PokedexView *done = *view;
+            *view = done->next;
+            free(done);
+        } else {
+            view = &(*view)->next;
+        }
+    }
+    ViewSlot **slot = &limboSlots;
+    while (*slot) {
+        if ((*slot)->retiredAt + 2 <= epoch) {
+            ViewSlot *done = *slot;
+            *slot = done->next;
+            freeViewSlot(done);
+        } else {
+            slot = &(*slot)->next;
+        }
+    }
+    OwnerRingView **ring = &limboRings;
+    while (*ring) {
+        if ((*ring)->retiredAt + 2 <= epoch) {
+            OwnerRingView *done = *ring;
+            *ring = done->next;
+            free(done);
+        } else {
+            ring = &(*ring)->next;
+        }
+    }
+}
+
+// Caller holds publishLock and ownerRingLock (either mode)
+static int buildOwnerRing(void) {
+
+    // Keep the index at most half full so probe runs stay short
+    uint32_t size = 1;
+    while (size < 2 * ownerCount)
+        size *= 2;
+    OwnerRingView *ring = malloc(sizeof(OwnerRingView) + ownerCount * sizeof(ViewSlot *) +
+                                 size * sizeof(int));
+    if (!ring)
+        return 0;
+    ring->next = NULL;
+    ring->retiredAt = 0;
+    ring->count = 0;
+    ring->mask = size - 1;
+    ring->index = (int *)(ring->owners + ownerCount);
+    for (uint32_t i = 0; i < size; i++)
+        ring->index[i] = -1;
+
+    ViewSlot *gone = NULL;
+    OwnerCursor cursor;
+    ownerCursorStart(&cursor, OWNERS_FORWARD);
+    for (OwnerNode *cur = ownerCursorNext(&cursor); cur; cur = ownerCursorNext(&cursor)) {
+        ViewSlot *slot = cur->viewSlot;
+        if (!slot)
+            continue;
+        if (__atomic_load_n(&cur->merged, __ATOMIC_ACQUIRE)) {
+            // Merged away: drop it from this version on, retire it once the old one is out
+            slot->next = gone;
+            gone = slot;
+            cur->viewSlot = NULL;
+            continue;
+        }
+        uint32_t at = slot->nameHash & ring->mask;
+        while (ring->index[at] >= 0)
+            at = (at + 1) & ring->mask;
+        ring->index[at] = ring->count;
+        ring->owners[ring->count++] = slot;
+    }
+
+    OwnerRingView *old = __atomic_exchange_n(&publishedRing, ring, __ATOMIC_SEQ_CST);
+    unsigned long epoch = __atomic_load_n(&globalEpoch, __ATOMIC_SEQ_CST);
+    if (old) {
+        old->retiredAt = epoch;
+        old->next = limboRings;
+        limboRings = old;
+    }
+    while (gone) {
+        ViewSlot *slot = gone;
+        gone = slot->next;
+        slot->retiredAt = epoch;
+        slot->next = limboSlots;
+        limboSlots = slot;
+    }
+    return 1;
+}
+
+/**
+ * @brief Publish a fresh copy of one owner's Pokedex in its slot.
+ * @param owner owner that changed
+ * @return 1 on success, 0 if out of memory (readers keep the previous version)
+ * Why we made it: Caller holds ownerRingLock (either mode) and owner->lock, so the copy is
+ * consistent. Only the owner's slot changes; the ring is rebuilt only for a new owner.
+ */
+int publishOwnerView(OwnerNode *owner) {
+
+    if (!owner || __atomic_load_n(&owner->merged, __ATOMIC_ACQUIRE))
+        return 1;
+
+    // Copy outside publishLock; only this owner's lock holder replaces its view
+    PokedexView *fresh = createPokedexView(owner);
+    if (!fresh)
+        return 0;
+
+    pthread_mutex_lock(&publishLock);
+    int ok = 1;
+    if (!owner->viewSlot) {
+        owner->viewSlot = createViewSlot(owner);
+        if (!owner->viewSlot) {
+            pthread_mutex_unlock(&publishLock);
+            free(fresh);
+            return 0;
+        }
+        __atomic_store_n(&owner->viewSlot->view, fresh, __ATOMIC_RELEASE);
+        ok = buildOwnerRing();
+    } else {
+        PokedexView *old = __atomic_exchange_n(&owner->viewSlot->view, fresh, __ATOMIC_SEQ_CST);
+        old->retiredAt = __atomic_load_n(&globalEpoch, __ATOMIC_SEQ_CST);
+        old->next = limboViews;
+        limboViews = old;
+    }
+    reclaimRetired();
+    pthread_mutex_unlock(&publishLock);
+    return ok;
+}
+
+/**
+ * @brief Publish a new ring version after owners were added, sorted or merged away.
+ * @return 1 on success, 0 if out of memory (readers keep the previous version)
+ * Why we made it: Caller holds ownerRingLock (either mode); merged owners' slots leave
+ * the ring here and are retired with it.
+ */
+int publishOwnerRing(void) {
+
+    pthread_mutex_lock(&publishLock);
+    int ok = buildOwnerRing();
+    reclaimRetired();
+    pthread_mutex_unlock(&publishLock);
+    return ok;
+}
+
+/**
+ * @brief Enter a read-side critical section and load the published ring.
+ * @return current ring version (NULL before the first publish); valid until donePublishedRing
+ */
+const OwnerRingView *readPublishedRing(void) {
+
+    for (int i = 0; readerSlot < 0 && i < EPOCH_READER_SLOTS; i++) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&readerSlotTaken[i], &expected, 1, 0, __ATOMIC_SEQ_CST,
+                                        __ATOMIC_SEQ_CST))
+            readerSlot = i;
+    }
+    if (readerSlot < 0) {
+        pthread_mutex_lock(&publishLock);
+        readerHoldsPublishLock = 1;
+        return publishedRing;
+    }
+
+    __atomic_store_n(&readerEpochs[readerSlot], __atomic_load_n(&globalEpoch, __ATOMIC_SEQ_CST),
+                     __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&publishedRing, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Leave the read-side critical section opened by readPublishedRing.
+ */
+void donePublishedRing(void) {
+
+    if (readerHoldsPublishLock) {
+        readerHoldsPublishLock = 0;
+        pthread_mutex_unlock(&publishLock);
+        return;
+    }
+    __atomic_store_n(&readerEpochs[readerSlot], 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Find an owner's published Pokedex by name through the ring's hash index.
+ * @param ring ring version from readPublishedRing (may be NULL)
+ * @param name owner name
+ * @return that owner's view or NULL
+ */
+const PokedexView *findPublishedView(const OwnerRingView *ring, const char *name) {
+
+    if (!ring || !name)
+        return NULL;
+    uint32_t hash = ownerNameHash(name);
+    for (uint32_t at = hash & ring->mask; ring->index[at] >= 0; at = (at + 1) & ring->mask) {
+        const ViewSlot *slot = ring->owners[ring->index[at]];
+        if (slot->nameHash == hash && strcmp(slot->ownerName, name) == 0)
+            return __atomic_load_n(&slot->view, __ATOMIC_ACQUIRE);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Get the current view of the i-th owner in a ring version.
+ * @param ring ring version from readPublishedRing
+ * @param i position in ring order (0 .. count - 1)
+ * @return that owner's view, valid until donePublishedRing
+ */
+const PokedexView *ringViewAt(const OwnerRingView *ring, int i) {
+
+    return __atomic_load_n(&ring->owners[i]->view, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Free every published and retired version (no readers may be left).
+ */
+void releasePublishedViews(void) {
+
+    pthread_mutex_lock(&publishLock);
+    free(publishedRing);
+    publishedRing = NULL;
+    while (limboRings) {
+        OwnerRingView *ring = limboRings;
+        limboRings = ring->next;
+        free(ring);
+    }
+    while (limboViews) {
+        PokedexView *view = limboViews;
+        limboViews = view->next;
+        free(view);
+    }
+    while (limboSlots) {
+        ViewSlot *slot = limboSlots;
+        limboSlots = slot->next;
+        freeViewSlot(slot);
+    }
+    for (int s = 0; s < OWNER_SHARDS; s++) {
+        OwnerNode *cur = ownerShards[s].head;
+        for (size_t i = 0; i < ownerShards[s].count; i++, cur = cur->next) {
+            if (cur->viewSlot)
+                freeViewSlot(cur->viewSlot);
+            cur->viewSlot = NULL;
+        }
+    }
+    pthread_mutex_unlock(&publishLock);
+}
+
+/* ------------------------------------------------------------
+   24) Sharded Owner Registry
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Hash an owner name (32-bit FNV-1a).
+ * @param name owner name
+ * @return hash; the low bits select the shard, the rest the index bucket
+ */
+uint32_t ownerNameHash(const char *name) {
+
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)name; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Start a merged walk over every shard.
+ * @param cursor cursor to initialize
+ * @param walk order to produce
+ * Why we made it: Shards never share a ring, so global order is rebuilt by a k-way merge.
+ */
+void ownerCursorStart(OwnerCursor *cursor, OwnerWalk walk) {
+
+    cursor->walk = walk;
+    for (int s = 0; s < OWNER_SHARDS; s++) {
+        OwnerNode *head = ownerShards[s].head;
+        cursor->next[s] = (head && walk == OWNERS_BACKWARD) ? head->prev : head;
+    }
+}
+
+/**
+ * @brief Next owner of a merged walk; the registry must not change during the walk.
+ * @param cursor cursor from ownerCursorStart
+ * @return next owner or NULL at the end
+ */
+OwnerNode *ownerCursorNext(OwnerCursor *cursor) {
+
+    // OWNER_SHARDS is small, so a linear pick of the best head beats keeping a heap
+    int best = -1;
+    for (int s = 0; s < OWNER_SHARDS; s++) {
+        const OwnerNode *candidate = cursor->next[s];
+        if (!candidate)
+            continue;
+        if (best < 0) {
+            best = s;
+            continue;
+        }
+        const OwnerNode *leader = cursor->next[best];
+        int better;
+        if (cursor->walk == OWNERS_BY_NAME)
+            better = strcmp(candidate->ownerName, leader->ownerName) < 0;
+        else if (cursor->walk == OWNERS_BACKWARD)
+            better = candidate->listOrder > leader->listOrder;
+        else
+            better = candidate->listOrder < leader->listOrder;
+        if (better)
+            best = s;
+    }
+    if (best < 0)
+        return NULL;
+
+    OwnerNode *owner = cursor->next[best];
+    OwnerNode *head = ownerShards[best].head;
+    if (cursor->walk == OWNERS_BACKWARD)
+        cursor->next[best] = owner == head ? NULL : owner->prev;
+    else
+        cursor->next[best] = owner->next == head ? NULL : owner->next;
+    return owner;
+}
+
+/* ------------------------------------------------------------
+   25) Multi-Merge (Parallel Flatten + K-Way Heap Merge)
+   ------------------------------------------------------------ */
+
+#define PARALLEL_THREADS 4
+#define MERGE_OWNERS_PER_THREAD 32 // Fewer owners than this per thread isn't worth a thread
+
+typedef struct {
+    ParallelTask task;
+    void *ctx;
+    int count;
+    int next; // Next unclaimed index (atomic)
+} ParallelJob;
+
+static void *parallelWorker(void *arg) {
+
+    ParallelJob *job = arg;
+    int index;
+    while ((index = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->count)
+        job->task(index, job->ctx);
+    return NULL;
+}
+
+/**
+ * @brief Run task(0) .. task(count - 1) on up to `threads` threads, the caller included.
+ * @param count number of tasks
+ * @param threads threads wanted (clamped to PARALLEL_THREADS and count)
+ * @param task function receiving the task index and ctx
+ * @param ctx shared context
+ * Why we made it: Each task claims the next index, so uneven tasks still balance out.
+ */
+void parallelFor(int count, int threads, ParallelTask task, void *ctx) {
+
+    ParallelJob job = {task, ctx, count, 0};
+    pthread_t helpers[PARALLEL_THREADS - 1];
+    if (threads > PARALLEL_THREADS)
+        threads = PARALLEL_THREADS;
+    if (threads > count)
+        threads = count;
+
+    int started = 0;
+    while (started < threads - 1 &&
+           pthread_create(&helpers[started], NULL, parallelWorker, &job) == 0)
+        started++;
+    // A helper that failed to start only means fewer hands
+    parallelWorker(&job);
+    for (int i = 0; i < started; i++)
+        pthread_join(helpers[i], NULL);
+}
+
+typedef struct {
+    const PokemonData **items; // Ascending by ID
+    int length;
+    int pos;
+} MergeRun;
+
+typedef struct {
+    OwnerNode **owners;
+    MergeRun *runs;
+} FlattenJob;
+
+// In-order walk into a run, skipping tombstones; IDs are unique, so a tree never holds
+// more than POKEDEX_SIZE nodes and a fixed stack is always deep enough
+static void flattenOwnerTask(int index, void *ctx) {
+
+    FlattenJob *job = ctx;
+    MergeRun *run = &job->runs[index];
+    PokemonNode *stack[POKEDEX_SIZE];
+    int depth = 0;
+    PokemonNode *current = job->owners[index]->pokedexRoot;
+
+    run->length = 0;
+    run->pos = 0;
+    while (current != NULL || depth > 0) {
+        while (current != NULL) {
+            stack[depth++] = current;
+            current = current->left;
+        }
+        current = stack[--depth];
+        if (!current->dead)
+            run->items[run->length++] = current->data;
+        current = current->right;
+    }
+}
+
+// Min-heap of run indices keyed by each run's current ID
+static void siftDownRuns(int *heap, int size, const MergeRun *runs, int at) {
+
+    for (;;) {
+        int smallest = at;
+        int left = 2 * at + 1;
+        int right = left + 1;
+        if (left < size && runs[heap[left]].items[runs[heap[left]].pos]->id <
+                               runs[heap[smallest]].items[runs[heap[smallest]].pos]->id)
+            smallest = left;
+        if (right < size && runs[heap[right]].items[runs[heap[right]].pos]->id <
+                                runs[heap[smallest]].items[runs[heap[smallest]].pos]->id)
+            smallest = right;
+        if (smallest == at)
+            return;
+        int tmp = heap[at];
+        heap[at] = heap[smallest];
+        heap[smallest] = tmp;
+        at = smallest;
+    }
+}
+
+/**
+ * @brief Fold many owners' Pokedexes into ownerIn's in one pass; the others are untouched.
+ * @param ownerIn owner that receives the Pokemon (keeps an undo snapshot)
+ * @param owners owners whose Pokemon are copied (distinct, not ownerIn)
+ * @param count number of owners
+ * @return number of Pokemon ownerIn ends up with, or -1 if out of memory (nothing changed)
+ * Why we made it: Flattening runs in parallel; one heap merge drops duplicate IDs and the
+ * tree is built balanced once, instead of re-inserting everything pair by pair.
+ */
+int mergePokedexesInto(OwnerNode *ownerIn, OwnerNode **owners, int count) {
+
+    int total = count + 1;
+    OwnerNode **all = malloc((size_t)total * sizeof(OwnerNode *));
+    MergeRun *runs = malloc((size_t)total * sizeof(MergeRun));
+    const PokemonData **items = malloc((size_t)total * POKEDEX_SIZE * sizeof(PokemonData *));
+    int *heap = malloc((size_t)total * sizeof(int));
+    if (!all || !runs || !items || !heap) {
+        free(all);
+        free(runs);
+        free(items);
+        free(heap);
+        return -1;
+    }
+
+    thawPokedex(ownerIn);
+    compactPokedex(ownerIn);
+    all[0] = ownerIn;
+    memcpy(all + 1, owners, (size_t)count * sizeof(OwnerNode *));
+    for (int i = 0; i < total; i++)
+        runs[i].items = items + (size_t)i * POKEDEX_SIZE;
+
+    FlattenJob job = {all, runs};
+    parallelFor(total, 1 + total / MERGE_OWNERS_PER_THREAD, flattenOwnerTask, &job);
+
+    int size = 0;
+    for (int i = 0; i < total; i++) {
+        if (runs[i].length > 0)
+            heap[size++] = i;
+    }
+    for (int i = size / 2 - 1; i >= 0; i--)
+        siftDownRuns(heap, size, runs, i);
+
+    // Equal IDs surface one after another, so keeping the first of each dedupes
+    PokemonNode *merged[POKEDEX_SIZE];
+    int distinct = 0;
+    int failed = 0;
+    while (size > 0) {
+        MergeRun *run = &runs[heap[0]];
+        const PokemonData *data = run->items[run->pos++];
+        if (distinct == 0 || merged[distinct - 1]->data->id != data->id) {
+            PokemonNode *node = createPokemonNode(data);
+            if (!node) {
+                failed = 1;
+                break;
+            }
+            merged[distinct++] = node;
+        }
+        if (run->pos == run->length)
+            heap[0] = heap[--size];
+        siftDownRuns(heap, size, runs, 0);
+    }
+
+    free(all);
+    free(runs);
+    free(items);
+    free(heap);
+    if (failed) {
+        for (int i = 0; i < distinct; i++)
+            freePokemonNode(merged[i]);
+        return -1;
+    }
+
+    snapshotPokedex(ownerIn);
+    freePokemonTree(ownerIn->pokedexRoot);
+    ownerIn->pokedexRoot = buildBalancedTree(merged, distinct);
+    return distinct;
+}
+
+/**
+ * @brief Merge many owners into ownerIn, then unlink and free them all.
+ * @param ownerIn owner that keeps the merged Pokedex
+ * @param owners owners that are removed (distinct, not ownerIn)
+ * @param count number of owners
+ * @return number of Pokemon ownerIn ends up with, or -1 if out of memory (nothing changed)
+ */
+int mergeManyOwners(OwnerNode *ownerIn, OwnerNode **owners, int count) {
+
+    int result = mergePokedexesInto(ownerIn, owners, count);
+    if (result < 0)
+        return result;
+    // Unlinking is O(1) per owner, so the whole batch is one pass over the list
+    for (int i = 0; i < count; i++) {
+        removeOwnerFromCircularList(owners[i]);
+        freeOwnerNode(owners[i]);
+    }
+    return result;
+}
+
+/**
+ * @brief Menu entry: merge a list of owners into one, removing them.
+ * Why we made it: Consolidation folds hundreds of accounts into one owner at a time.
+ */
+void mergeManyMenu(void) {
+
+    printf("=== Merge Many Pokedexes ===\n");
+    printf("Enter name of owner to keep: ");
+    char *nameIn = getDynamicInput();
+    OwnerNode *ownerIn = findOwnerByName(nameIn);
+    free(nameIn);
+    if (!ownerIn) {
+        printf("Cannot find owners\n");
+        return;
+    }
+    int count = readIntSafe("How many owners to merge in? ");
+    if (count < 1 || (size_t)count >= ownerCount) {
+        printf("Invalid number of owners.\n");
+        return;
+    }
+
+    OwnerNode **owners = malloc((size_t)count * sizeof(OwnerNode *));
+    if (!owners) {
+        printf("Not enough memory to merge.\n");
+        return;
+    }
+    // Read every name before judging any, so a bad one doesn't desync the input
+    int valid = 1;
+    for (int i = 0; i < count; i++) {
+        printf("Owner %d to merge in: ", i + 1);
+        char *name = getDynamicInput();
+        owners[i] = findOwnerByName(name);
+        if (!owners[i] || owners[i] == ownerIn) {
+            if (valid)
+                printf("Cannot find owner '%s'\n", name ? name : "");
+            valid = 0;
+        }
+        for (int j = 0; valid && j < i; j++) {
+            if (owners[j] == owners[i]) {
+                printf("Owner '%s' is listed twice\n", name);
+                valid = 0;
+            }
+        }
+        free(name);
+    }
+    if (!valid) {
+        free(owners);
+        return;
+    }
+
+    printf("Merging %d Pokedexes into %s...\n", count, ownerIn->ownerName);
+    int result = mergeManyOwners(ownerIn, owners, count);
+    free(owners);
+    if (result < 0) {
+        printf("Not enough memory to merge.\n");
+        return;
+    }
+    printf("Merge completed: %s now has %d Pokemon, %d owners removed.\n", ownerIn->ownerName,
+           result, count);
+}
+
+/* ------------------------------------------------------------
+   26) Parallel Traversal (Work-Stealing)
+   ------------------------------------------------------------ */
+
+#define TRAVERSE_SPLIT_DEPTH 2       // Nodes deeper than this are walked in one go, not split off
+#define TRAVERSE_ROOTS_PER_THREAD 32 // Fewer trees than this per thread aren't worth a thread
+
+typedef struct {
+    PokemonNode *node;
+    int depth;
+} TraverseTask;
+
+// The owning worker pushes and pops at bottom; thieves take from top
+typedef struct {
+    pthread_mutex_t lock;
+    TraverseTask *tasks;
+    int capacity;
+    int top;
+    int bottom;
+} TaskDeque;
+
+typedef struct {
+    TaskDeque deques[PARALLEL_THREADS];
+    unsigned char *states; // One partial result per worker
+    const TraversalReducer *reducer;
+    void *ctx;
+    int workers;
+    long pending; // Tasks pushed but not yet finished (atomic)
+} TraversePool;
+
+// Pre-order with a fixed stack: IDs are unique, so a subtree never exceeds POKEDEX_SIZE nodes
+static void reduceSubtree(PokemonNode *root, const TraversalReducer *reducer, void *state, void *ctx) {
+
+    PokemonNode *stack[POKEDEX_SIZE];
+    int depth = 0;
+    if (root)
+        stack[depth++] = root;
+    while (depth > 0) {
+        PokemonNode *current = stack[--depth];
+        if (!current->dead)
+            reducer->visit(state, current, ctx);
+        if (current->right)
+            stack[depth++] = current->right;
+        if (current->left)
+            stack[depth++] = current->left;
+    }
+}
+
+static int dequePush(TaskDeque *deque, TraverseTask task) {
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->bottom == deque->capacity) {
+        if (deque->top > 0) {
+            // Thieves left room at the front
+            memmove(deque->tasks, deque->tasks + deque->top,
+                    (size_t)(deque->bottom - deque->top) * sizeof(TraverseTask));
+            deque->bottom -= deque->top;
+            deque->top = 0;
+        } else {
+            TraverseTask *grown = realloc(deque->tasks, (size_t)deque->capacity * 2 * sizeof(TraverseTask));
+            if (!grown) {
+                pthread_mutex_unlock(&deque->lock);
+                return 0;
+            }
+            deque->tasks = grown;
+            deque->capacity *= 2;
+        }
+    }
+    deque->tasks[deque->bottom++] = task;
+    pthread_mutex_unlock(&deque->lock);
+    return 1;
+}
+
+static int dequeTake(TaskDeque *deque, int fromTop, TraverseTask *task) {
+
+    int found = 0;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->top < deque->bottom) {
+        *task = fromTop ? deque->tasks[deque->top++] : deque->tasks[--deque->bottom];
+        found = 1;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+// Split the top levels off as stealable tasks, then walk the rest of the subtree here
+static void runTraverseTask(TraversePool *pool, int worker, void *state, TraverseTask task) {
+
+    PokemonNode *node = task.node;
+    int depth = task.depth;
+    while (node && depth < TRAVERSE_SPLIT_DEPTH) {
+        if (node->right) {
+            TraverseTask split = {node->right, depth + 1};
+            __atomic_add_fetch(&pool->pending, 1, __ATOMIC_RELAXED);
+            if (!dequePush(&pool->deques[worker], split)) {
+                // No room to share it: just do it ourselves
+                __atomic_sub_fetch(&pool->pending, 1, __ATOMIC_RELAXED);
+                reduceSubtree(split.node, pool->reducer, state, pool->ctx);
+            }
+        }
+        if (!node->dead)
+            pool->reducer->visit(state, node, pool->ctx);
+        node = node->left;
+        depth++;
+    }
+    reduceSubtree(node, pool->reducer, state, pool->ctx);
+}
+
+static void traverseWorkerTask(int index, void *ctx) {
+
+    TraversePool *pool = ctx;
+    void *state = pool->states + (size_t)index * pool->reducer->stateSize;
+    TraverseTask task;
+    while (__atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) > 0) {
+        int found = dequeTake(&pool->deques[index], 0, &task);
+        for (int i = 1; !found && i < pool->workers; i++)
+            found = dequeTake(&pool->deques[(index + i) % pool->workers], 1, &task);
+        if (!found) {
+            // Someone is still splitting or walking; their leftovers may show up
+            sched_yield();
+            continue;
+        }
+        runTraverseTask(pool, index, state, task);
+        __atomic_sub_fetch(&pool->pending, 1, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Run a reducer over every live node of many trees, on several threads when it pays.
+ * @param roots tree roots (NULL entries are skipped)
+ * @param count number of roots
+ * @param reducer how to build, fill and combine partial results
+ * @param ctx caller data handed to every visit() call
+ * @param result receives the combined result (reducer->stateSize bytes)
+ * Why we made it: Idle workers steal split-off subtrees from busy ones, so a few big
+ * Pokedexes among many small ones don't leave the other cores waiting.
+ */
+void parallelTraverse(PokemonNode *const *roots, int count, const TraversalReducer *reducer,
+                      void *ctx, void *result) {
+
+    TraversePool pool;
+    pool.workers = 1 + count / TRAVERSE_ROOTS_PER_THREAD;
+    if (pool.workers > PARALLEL_THREADS)
+        pool.workers = PARALLEL_THREADS;
+    pool.reducer = reducer;
+    pool.ctx = ctx;
+    pool.pending = 0;
+    pool.states = pool.workers > 1 ? malloc((size_t)pool.workers * reducer->stateSize) : NULL;
+
+    // Each worker starts with an even share of the trees
+    int ready = 0;
+    while (pool.states && ready < pool.workers) {
+        int first = (int)((long)count * ready / pool.workers);
+        int last = (int)((long)count * (ready + 1) / pool.workers);
+        TaskDeque *deque = &pool.deques[ready];
+        deque->capacity = last - first + TRAVERSE_SPLIT_DEPTH * 4;
+        deque->tasks = malloc((size_t)deque->capacity * sizeof(TraverseTask));
+        if (!deque->tasks)
+            break;
+        pthread_mutex_init(&deque->lock, NULL);
+        deque->top = 0;
+        deque->bottom = 0;
+        for (int i = first; i < last; i++) {
+            if (roots[i])
+                deque->tasks[deque->bottom++] = (TraverseTask){roots[i], 0};
+        }
+        pool.pending += deque->bottom;
+        reducer->init(pool.states + (size_t)ready * reducer->stateSize);
+        ready++;
+    }
+
+    reducer->init(result);
+    if (ready < pool.workers) {
+        // Too few trees to split, or no memory to: one sequential pass
+        for (int i = 0; i < ready; i++) {
+            pthread_mutex_destroy(&pool.deques[i].lock);
+            free(pool.deques[i].tasks);
+        }
+        free(pool.states);
+        for (int i = 0; i < count; i++)
+            reduceSubtree(roots[i], reducer, result, ctx);
+        return;
+    }
+
+    parallelFor(pool.workers, pool.workers, traverseWorkerTask, &pool);
+    for (int i = 0; i < pool.workers; i++) {
+        reducer->combine(result, pool.states + (size_t)i * reducer->stateSize);
+        pthread_mutex_destroy(&pool.deques[i].lock);
+        free(pool.deques[i].tasks);
+    }
+    free(pool.states);
+}
+
+static int isStrongerPokemon(const PokemonData *a, const PokemonData *b) {
+
+    if (!a || !b)
+        return a != NULL;
+    float strengthA = pokemonCalcStregth(a);
+    float strengthB = pokemonCalcStregth(b);
+    return strengthA > strengthB || (strengthA == strengthB && a->id < b->id);
+}
+
+static void statsInit(void *state) {
+
+    PokedexStats *stats = state;
+    memset(stats, 0, sizeof(*stats));
+    stats->strongest = NULL;
+}
+
+static void statsVisit(void *state, const PokemonNode *node, void *ctx) {
+
+    (void)ctx;
+    PokedexStats *stats = state;
+    const PokemonData *data = node->data;
+    stats->pokemon++;
+    stats->typeCounts[data->TYPE]++;
+    stats->totalHp += data->hp;
+    stats->totalAttack += data->attack;
+    if (isStrongerPokemon(data, stats->strongest))
+        stats->strongest = data;
+}
+
+static void statsCombine(void *into, const void *from) {
+
+    PokedexStats *total = into;
+    const PokedexStats *part = from;
+    total->pokemon += part->pokemon;
+    for (int i = 0; i < POKEMON_TYPE_COUNT; i++)
+        total->typeCounts[i] += part->typeCounts[i];
+    total->totalHp += part->totalHp;
+    total->totalAttack += part->totalAttack;
+    if (isStrongerPokemon(part->strongest, total->strongest))
+        total->strongest = part->strongest;
+}
+
+static const TraversalReducer statsReducer = {
+    sizeof(PokedexStats), statsInit, statsVisit, statsCombine,
+};
+
+/**
+ * @brief Type histogram and HP/attack totals over many Pokedexes.
+ * @param roots tree roots (NULL entries are skipped)
+ * @param count number of roots
+ * @param stats receives the totals
+ */
+void collectPokedexStats(PokemonNode *const *roots, int count, PokedexStats *stats) {
+
+    parallelTraverse(roots, count, &statsReducer, NULL, stats);
+}
+
+/**
+ * @brief Print statistics gathered by collectPokedexStats.
+ * @param out destination stream
+ * @param stats totals to print
+ * @param owners number of owners the totals cover
+ */
+void writePokedexStats(FILE *out, const PokedexStats *stats, size_t owners) {
+
+    fprintf(out, "Owners: %zu, Pokemon: %ld\n", owners, stats->pokemon);
+    if (stats->pokemon == 0)
+        return;
+    fprintf(out, "Average HP: %.2f, Average Attack: %.2f\n", (double)stats->totalHp / stats->pokemon,
+            (double)stats->totalAttack / stats->pokemon);
+    fprintf(out, "Strongest: %s (ID %d)\n", stats->strongest->name, stats->strongest->id);
+    fprintf(out, "Pokemon by type:\n");
+    for (int i = 0; i < POKEMON_TYPE_COUNT; i++) {
+        if (stats->typeCounts[i] > 0)
+            fprintf(out, "  %s: %ld\n", getTypeName((PokemonType)i), stats->typeCounts[i]);
+    }
+}
+
+/**
+ * @brief Menu entry: statistics over every owner's Pokedex.
+ * Why we made it: One summary of the whole registry instead of displaying each owner.
+ */
+void pokedexStatsMenu(void) {
+
+    printf("=== Pokedex Statistics ===\n");
+    if (ownerCount == 0) {
+        printf("No existing Pokedexes.\n");
+        return;
+    }
+    PokemonNode **roots = malloc(ownerCount * sizeof(PokemonNode *));
+    if (!roots) {
+        printf("Not enough memory for statistics.\n");
+        return;
+    }
+    OwnerCursor cursor;
+    ownerCursorStart(&cursor, OWNERS_FORWARD);
+    int count = 0;
+    for (OwnerNode *cur = ownerCursorNext(&cursor); cur; cur = ownerCursorNext(&cursor))
+        roots[count++] = cur->pokedexRoot;
+
+    PokedexStats stats;
+    collectPokedexStats(roots, count, &stats);
+    free(roots);
+    writePokedexStats(stdout, &stats, ownerCount);
+}
+
+/* ------------------------------------------------------------
+   27) Pipelined Scripted Runs (SPSC Rings)
+   ------------------------------------------------------------ */
+
+#define PIPELINE_RING_BYTES (1 << 16)
+#define PIPELINE_BLOCK 16384
+#define SPSC_SPINS 64 // Yields before a waiting side starts sleeping
+
+// Spin briefly (the other side is usually just behind), then sleep so an idle stage stays idle
+static void spscBackoff(int *spins) {
+
+    if (++*spins < SPSC_SPINS) {
+        sched_yield();
+        return;
+    }
+    struct timespec pause = {0, 100000};
+    nanosleep(&pause, NULL);
+}
+
+/**
+ * @brief Set up an empty ring.
+ * @param ring ring to initialize
+ * @param capacity size in bytes, a power of two
+ * @return 1 on success, 0 if out of memory
+ */
+int spscInit(SpscRing *ring, size_t capacity) {
+
+    ring->buf = malloc(capacity);
+    ring->capacity = capacity;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->closed = 0;
+    return ring->buf != NULL;
+}
+
+/**
+ * @brief Free a ring's buffer once both sides are done with it.
+ * @param ring ring to destroy
+ */
+void spscDestroy(SpscRing *ring) {
+
+    free(ring->buf);
+    ring->buf = NULL;
+}
+
+/**
+ * @brief Producer side: copy bytes in, waiting for room.
+ * @param ring ring to write to
+ * @param data bytes to copy
+ * @param len number of bytes; up to the capacity they become visible all at once
+ * @return len, or fewer if the ring was closed meanwhile
+ * Why we made it: No locks, just one acquire/release pair per batch of bytes.
+ */
+size_t spscWrite(SpscRing *ring, const char *data, size_t len) {
+
+    size_t done = 0;
+    int spins = 0;
+    while (done < len) {
+        if (__atomic_load_n(&ring->closed, __ATOMIC_ACQUIRE))
+            break;
+        size_t tail = ring->tail;
+        size_t room = ring->capacity - (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE));
+        size_t want = len - done < ring->capacity ? len - done : ring->capacity;
+        if (room < want) {
+            spscBackoff(&spins);
+            continue;
+        }
+        spins = 0;
+        size_t at = tail & (ring->capacity - 1);
+        size_t first = ring->capacity - at < want ? ring->capacity - at : want;
+        memcpy(ring->buf + at, data + done, first);
+        memcpy(ring->buf, data + done + first, want - first);
+        __atomic_store_n(&ring->tail, tail + want, __ATOMIC_RELEASE);
+        done += want;
+    }
+    return done;
+}
+
+/**
+ * @brief Consumer side: copy out whatever is there, waiting for at least one byte.
+ * @param ring ring to read from
+ * @param out destination buffer
+ * @param max room in out
+ * @return bytes copied, 0 once the ring is closed and drained
+ */
+size_t spscRead(SpscRing *ring, char *out, size_t max) {
+
+    int spins = 0;
+    for (;;) {
+        size_t head = ring->head;
+        // Check closed first: a close after the last write must not hide that write
+        int closed = __atomic_load_n(&ring->closed, __ATOMIC_ACQUIRE);
+        size_t ready = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) - head;
+        if (ready == 0) {
+            if (closed)
+                return 0;
+            spscBackoff(&spins);
+            continue;
+        }
+        size_t take = ready < max ? ready : max;
+        size_t at = head & (ring->capacity - 1);
+        size_t first = ring->capacity - at < take ? ring->capacity - at : take;
+        memcpy(out, ring->buf + at, first);
+        memcpy(out + first, ring->buf, take - first);
+        __atomic_store_n(&ring->head, head + take, __ATOMIC_RELEASE);
+        return take;
+    }
+}
+
+/**
+ * @brief Hang up: the reader sees end of data after draining, the writer stops.
+ * @param ring ring to close
+ */
+void spscClose(SpscRing *ring) {
+
+    __atomic_store_n(&ring->closed, 1, __ATOMIC_RELEASE);
+}
+
+static ssize_t pipelineCookieRead(void *cookie, char *buf, size_t size) {
+
+    return (ssize_t)spscRead(cookie, buf, size);
+}
+
+static ssize_t pipelineCookieWrite(void *cookie, const char *buf, size_t size) {
+
+    // A short count makes stdio flag the stream, as a failed write(2) would
+    return (ssize_t)spscWrite(cookie, buf, size);
+}
+
+static int pipelineCookieClose(void *cookie) {
+
+    spscClose(cookie);
+    return 0;
+}
+
+// Stage 1: read stdin in blocks and hand over whole lines, so every record the menus
+// pick up is a complete command
+static void *pipelineReader(void *arg) {
+
+    SpscRing *ring = arg;
+    char block[PIPELINE_BLOCK];
+    size_t held = 0; // Start of an unfinished line, kept from the previous read
+    for (;;) {
+        ssize_t got = read(STDIN_FILENO, block + held, sizeof(block) - held);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            break;
+        size_t filled = held + (size_t)got;
+        size_t complete = filled;
+        while (complete > 0 && block[complete - 1] != '\n')
+            complete--;
+        if (complete == 0)
+            complete = filled; // One line fills the block: pass it on in pieces
+        if (spscWrite(ring, block, complete) < complete)
+            return NULL; // The menus have exited
+        held = filled - complete;
+        memmove(block, block + complete, held);
+    }
+    spscWrite(ring, block, held);
+    spscClose(ring);
+    return NULL;
+}
+
+// Stage 3: drain formatted output to stdout
+static void *pipelineWriter(void *arg) {
+
+    SpscRing *ring = arg;
+    char block[PIPELINE_BLOCK];
+    size_t got;
+    while ((got = spscRead(ring, block, sizeof(block))) > 0) {
+        size_t done = 0;
+        while (done < got) {
+            ssize_t n = write(STDOUT_FILENO, block + done, got - done);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0) {
+                spscClose(ring); // stdout is gone; stop taking output
+                return NULL;
+            }
+            done += (size_t)n;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Run the menus with input reading and output writing on their own threads.
+ * @return process exit status
+ * Why we made it: A scripted run then costs its slowest stage, not the sum of reading,
+ * executing and writing. The menus themselves are untouched: stdin and stdout are
+ * swapped for streams over the rings, so the output is byte-for-byte the serial one.
+ */
+int runPipeline(void) {
+
+    SpscRing input, output;
+    if (!spscInit(&input, PIPELINE_RING_BYTES) || !spscInit(&output, PIPELINE_RING_BYTES)) {
+        spscDestroy(&input);
+        fprintf(stderr, "pipeline: out of memory\n");
+        return 1;
+    }
+    cookie_io_functions_t inputIo = {pipelineCookieRead, NULL, NULL, pipelineCookieClose};
+    cookie_io_functions_t outputIo = {NULL, pipelineCookieWrite, NULL, pipelineCookieClose};
+    FILE *in = fopencookie(&input, "r", inputIo);
+    FILE *out = fopencookie(&output, "w", outputIo);
+    pthread_t reader, writer;
+    int haveReader = in && out && pthread_create(&reader, NULL, pipelineReader, &input) == 0;
+    int haveWriter = haveReader && pthread_create(&writer, NULL, pipelineWriter, &output) == 0;
+    if (!haveWriter) {
+        fprintf(stderr, "pipeline: cannot start the I/O threads\n");
+        if (in)
+            fclose(in); // Also stops a reader that did start
+        if (out)
+            fclose(out);
+        if (haveReader)
+            pthread_join(reader, NULL);
+        spscDestroy(&input);
+        spscDestroy(&output);
+        return 1;
+    }
+    setvbuf(out, NULL, _IOFBF, PIPELINE_BLOCK);
+
+    // Stage 2 is this thread running the usual menus
+    FILE *realIn = stdin;
+    FILE *realOut = stdout;
+    stdin = in;
+    stdout = out;
+    mainMenu();
+    freeAllOwners();
+    stdin = realIn;
+    stdout = realOut;
+
+    fclose(out); // Flushes; the writer drains the rest, then sees the close
+    fclose(in);
+    // Input past "Exit" is never read; don't wait for stdin to end
+    pthread_cancel(reader);
+    pthread_join(reader, NULL);
+    pthread_join(writer, NULL);
+    spscDestroy(&input);
+    spscDestroy(&output);
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   28) Streaming Export (CSV / JSON Lines)
+   ------------------------------------------------------------ */
+
+#define EXPORT_BUFFER (1 << 20)
+#define EXPORT_ROW_MAX 128 // Longest pre-formatted species row, with room to spare
+
+/*
+ * The species half of a row never changes, so each species' CSV tail and JSON object
+ * are formatted once; exporting a Pokemon is then one copy of the owner's prefix and
+ * one copy of the species text.
+ */
+static char exportCsvRows[POKEDEX_SIZE + 1][EXPORT_ROW_MAX];
+static char exportJsonRows[POKEDEX_SIZE + 1][EXPORT_ROW_MAX];
+static unsigned char exportCsvLength[POKEDEX_SIZE + 1];
+static unsigned char exportJsonLength[POKEDEX_SIZE + 1];
+static int exportRowsReady;
+
+typedef struct {
+    FILE *out;
+    char *buf;    // EXPORT_BUFFER bytes
+    size_t used;
+    int failed;
+    char *scratch; // The current owner's escaped name
+    size_t scratchUsed;
+    size_t scratchCap;
+} ExportWriter;
+
+static void initExportRows(void) {
+
+    for (int id = 1; id <= POKEDEX_SIZE; id++) {
+        const PokemonData *data = &pokedex[id - 1];
+        int canEvolve = data->CAN_EVOLVE == CAN_EVOLVE;
+        exportCsvLength[id] = (unsigned char)snprintf(
+            exportCsvRows[id], EXPORT_ROW_MAX, "%d,%s,%s,%d,%d,%d\n", data->id, data->name,
+            getTypeName(data->TYPE), data->hp, data->attack, canEvolve);
+        exportJsonLength[id] = (unsigned char)snprintf(
+            exportJsonRows[id], EXPORT_ROW_MAX,
+            "{\"id\":%d,\"name\":\"%s\",\"type\":\"%s\",\"hp\":%d,\"attack\":%d,\"canEvolve\":%s}",
+            data->id, data->name, getTypeName(data->TYPE), data->hp, data->attack,
+            canEvolve ? "true" : "false");
+    }
+    exportRowsReady = 1;
+}
+
+static void exportFlush(ExportWriter *w) {
+
+    if (w->used > 0 && !w->failed && fwrite(w->buf, 1, w->used, w->out) != w->used)
+        w->failed = 1;
+    w->used = 0;
+}
+
+static void exportPut(ExportWriter *w, const char *data, size_t len) {
+
+    if (EXPORT_BUFFER - w->used < len) {
+        exportFlush(w);
+        if (len > EXPORT_BUFFER) {
+            // Only a huge owner name gets here: send it straight through
+            if (!w->failed && fwrite(data, 1, len, w->out) != len)
+                w->failed = 1;
+            return;
+        }
+    }
+    memcpy(w->buf + w->used, data, len);
+    w->used += len;
+}
+
+static int exportScratchByte(ExportWriter *w, char c) {
+
+    if (w->scratchUsed == w->scratchCap) {
+        size_t cap = w->scratchCap ? w->scratchCap * 2 : 64;
+        char *grown = realloc(w->scratch, cap);
+        if (!grown) {
+            w->failed = 1;
+            return 0;
+        }
+        w->scratch = grown;
+        w->scratchCap = cap;
+    }
+    w->scratch[w->scratchUsed++] = c;
+    return 1;
+}
+
+// CSV: quoted only when needed, quotes doubled. JSON: a quoted string with escapes.
+static void exportEscapeName(ExportWriter *w, const char *name, ExportFormat format) {
+
+    w->scratchUsed = 0;
+    if (format == EXPORT_CSV) {
+        int quote = strpbrk(name, ",\"\r\n") != NULL;
+        if (quote)
+            exportScratchByte(w, '"');
+        for (const char *c = name; *c; c++) {
+            if (*c == '"')
+                exportScratchByte(w, '"');
+            exportScratchByte(w, *c);
+        }
+        if (quote)
+            exportScratchByte(w, '"');
+        exportScratchByte(w, ',');
+        return;
+    }
+
+    static const char hex[] = "0123456789abcdef";
+    for (const char *prefix = "{\"owner\":\""; *prefix; prefix++)
+        exportScratchByte(w, *prefix);
+    for (const unsigned char *c = (const unsigned char *)name; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            exportScratchByte(w, '\\');
+            exportScratchByte(w, (char)*c);
+        } else if (*c < 0x20) {
+            const char escape[] = {'\\', 'u', '0', '0', hex[*c >> 4], hex[*c & 15]};
+            for (size_t i = 0; i < sizeof(escape); i++)
+                exportScratchByte(w, escape[i]);
+        } else {
+            exportScratchByte(w, (char)*c);
+        }
+    }
+    for (const char *suffix = "\",\"pokemon\":["; *suffix; suffix++)
+        exportScratchByte(w, *suffix);
+}
+
+// In-order (ascending ID) with a fixed stack, like flattenOwnerTask
+static void exportOwner(ExportWriter *w, const OwnerNode *owner, ExportFormat format) {
+
+    exportEscapeName(w, owner->ownerName, format);
+    if (w->failed)
+        return;
+
+    PokemonNode *stack[POKEDEX_SIZE];
+    int depth = 0;
+    int written = 0;
+    PokemonNode *current = owner->pokedexRoot;
+    while (current != NULL || depth > 0) {
+        while (current != NULL) {
+            stack[depth++] = current;
+            current = current->left;
+        }
+        current = stack[--depth];
+        if (!current->dead) {
+            int id = current->data->id;
+            if (format == EXPORT_CSV) {
+                exportPut(w, w->scratch, w->scratchUsed);
+                exportPut(w, exportCsvRows[id], exportCsvLength[id]);
+            } else {
+                if (written == 0)
+                    exportPut(w, w->scratch, w->scratchUsed);
+                else
+                    exportPut(w, ",", 1);
+                exportPut(w, exportJsonRows[id], exportJsonLength[id]);
+            }
+            written++;
+        }
+        current = current->right;
+    }
+
+    if (written > 0) {
+        if (format == EXPORT_JSONL)
+            exportPut(w, "]}\n", 3);
+    } else {
+        // Owners without Pokemon still get a line, so the export lists every owner
+        exportPut(w, w->scratch, w->scratchUsed);
+        if (format == EXPORT_CSV)
+            exportPut(w, ",,,,,\n", 6);
+        else
+            exportPut(w, "]}\n", 3);
+    }
+}
+
+/**
+ * @brief Write every owner and their Pokemon, with species stats, to a stream.
+ * @param out destination stream
+ * @param format CSV or JSON Lines
+ * @return number of owners written, or -1 if writing failed
+ * Why we made it: Analytics wants machine-readable rows. One pass over the owners and
+ * trees through a fixed-size buffer keeps memory flat however many owners there are.
+ */
+long exportOwners(FILE *out, ExportFormat format) {
+
+    ExportWriter w = {out, malloc(EXPORT_BUFFER), 0, 0, NULL, 0, 0};
+    if (!w.buf)
+        return -1;
+    if (!exportRowsReady)
+        initExportRows();
+    static const char csvHeader[] = "owner,id,name,type,hp,attack,can_evolve\n";
+    if (format == EXPORT_CSV)
+        exportPut(&w, csvHeader, sizeof(csvHeader) - 1);
+
+    long owners = 0;
+    OwnerCursor cursor;
+    ownerCursorStart(&cursor, OWNERS_FORWARD);
+    for (OwnerNode *cur = ownerCursorNext(&cursor); cur && !w.failed; cur = ownerCursorNext(&cursor)) {
+        exportOwner(&w, cur, format);
+        owners++;
+    }
+    exportFlush(&w);
+    if (fflush(out) != 0)
+        w.failed = 1;
+    free(w.buf);
+    free(w.scratch);
+    return w.failed ? -1 : owners;
+}
+
+/**
+ * @brief Menu entry: export all owners to a CSV or JSON Lines file.
+ */
+void exportOwnersMenu(void) {
+
+    printf("=== Export Pokedexes ===\n");
+    int choice = readIntSafe("Choose format (1 = CSV, 2 = JSON Lines): ");
+    if (choice != 1 && choice != 2) {
+        printf("Invalid format.\n");
+        return;
+    }
+    printf("Enter file name: ");
+    char *path = getDynamicInput();
+    if (!path || path[0] == '\0') {
+        printf("Invalid file name.\n");
+        free(path);
+        return;
+    }
+
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        printf("Cannot open '%s' for writing.\n", path);
+        free(path);
+        return;
+    }
+    long owners = exportOwners(out, choice == 1 ? EXPORT_CSV : EXPORT_JSONL);
+    if (fclose(out) != 0)
+        owners = -1;
+    if (owners < 0)
+        printf("Writing '%s' failed.\n", path);
+    else
+        printf("Exported %ld owners to %s.\n", owners, path);
+    free(path);
+}
+
+/* ------------------------------------------------------------
+   29) Parallel Bulk Import (CSV)
+   ------------------------------------------------------------ */
+
+#define IMPORT_CHUNKS_PER_THREAD 4  // Spare chunks let fast threads take over slow ones' work
+#define IMPORT_MIN_CHUNK (1 << 16)  // Smaller pieces aren't worth a task
+#define IMPORT_OWNERS_PER_THREAD 64 // Fewer owners than this per thread aren't worth a thread
+#define IMPORT_ID_WORDS ((POKEDEX_SIZE + 31) / 32)
+#define IMPORT_TOKEN_MAX 32         // Longer than any species name
+
+typedef struct {
+    char *name;                    // malloc'd; createOwner takes it
+    uint32_t hash;                 // ownerNameHash(name)
+    uint32_t ids[IMPORT_ID_WORDS]; // Bit id - 1 set for each species listed (so no duplicates)
+    OwnerNode *owner;
+} ImportRecord;
+
+typedef struct {
+    const char *start;
+    const char *end;
+    ImportRecord *records;
+    int count;
+    int capacity;
+    int badLines;
+    const char *firstBad; // Start of the first rejected line, NULL if none
+    int failed;           // Out of memory
+} ImportChunk;
+
+typedef struct {
+    ImportRecord **records;
+    int failed; // Some owner couldn't be built (atomic)
+} ImportBuild;
+
+static void trimImportRange(const char **start, const char **end) {
+
+    while (*start < *end && (**start == ' ' || **start == '\t'))
+        (*start)++;
+    while (*end > *start && ((*end)[-1] == ' ' || (*end)[-1] == '\t' || (*end)[-1] == '\r'))
+        (*end)--;
+}
+
+// A species token is an ID or a name (any case); 0 if it is neither
+static int parseImportSpecies(const char *start, const char *end) {
+
+    size_t len = (size_t)(end - start);
+    if (len == 0 || len >= IMPORT_TOKEN_MAX)
+        return 0;
+    int id = 0;
+    const char *c = start;
+    while (c < end && isdigit((unsigned char)*c) && id <= POKEDEX_SIZE)
+        id = id * 10 + (*c++ - '0');
+    if (c == end)
+        return id >= 1 && id <= POKEDEX_SIZE ? id : 0;
+
+    char token[IMPORT_TOKEN_MAX];
+    memcpy(token, start, len);
+    token[len] = '\0';
+    return findSpeciesByName(token);
+}
+
+/*
+ * A name holding a comma or quote comes quoted, quotes doubled, as exportEscapeName
+ * writes it. Names are read a line at a time, so a quoted one never spans lines.
+ * Sets *nameStart / *nameEnd to the name (still escaped if *quoted) and returns the
+ * comma that ends it or end; NULL if the quotes are unbalanced or text follows them.
+ */
+static const char *scanImportName(const char *line, const char *end, const char **nameStart,
+                                  const char **nameEnd, int *quoted) {
+
+    const char *start = line;
+    const char *stop = end;
+    trimImportRange(&start, &stop);
+    *quoted = start < stop && *start == '"';
+    if (!*quoted) {
+        const char *comma = memchr(line, ',', (size_t)(end - line));
+        *nameStart = line;
+        *nameEnd = comma ? comma : end;
+        trimImportRange(nameStart, nameEnd);
+        return comma ? comma : end;
+    }
+
+    const char *c = start + 1;
+    for (;;) {
+        c = memchr(c, '"', (size_t)(end - c));
+        if (!c)
+            return NULL;
+        if (c + 1 < end && c[1] == '"') {
+            c += 2;
+            continue;
+        }
+        break;
+    }
+    *nameStart = start + 1;
+    *nameEnd = c;
+    for (c++; c < end && (*c == ' ' || *c == '\t' || *c == '\r'); c++)
+        ;
+    return c == end || *c == ',' ? c : NULL;
+}
+
+// 1 = record filled, 0 = blank line, -1 = bad line, -2 = out of memory
+static int parseImportLine(const char *line, const char *end, ImportRecord *record) {
+
+    const char *nameStart, *nameEnd;
+    int quoted;
+    const char *token = scanImportName(line, end, &nameStart, &nameEnd, &quoted);
+    if (!token)
+        return -1;
+    if (nameStart == nameEnd) {
+        const char *rest = line;
+        trimImportRange(&rest, &end);
+        return rest == end ? 0 : -1;
+    }
+
+    memset(record->ids, 0, sizeof(record->ids));
+    while (token < end) {
+        const char *tokenStart = token + 1;
+        const char *tokenEnd = memchr(tokenStart, ',', (size_t)(end - tokenStart));
+        if (!tokenEnd)
+            tokenEnd = end;
+        token = tokenEnd;
+        trimImportRange(&tokenStart, &tokenEnd);
+        if (tokenStart == tokenEnd)
+            continue; // "Ash," or "Ash,25,,6": nothing to add
+        int id = parseImportSpecies(tokenStart, tokenEnd);
+        if (id == 0)
+            return -1;
+        record->ids[(id - 1) / 32] |= 1u << ((id - 1) % 32);
+    }
+
+    record->name = malloc((size_t)(nameEnd - nameStart) + 1);
+    if (!record->name)
+        return -2;
+    size_t nameLength = 0;
+    for (const char *c = nameStart; c < nameEnd; c++) {
+        record->name[nameLength++] = *c;
+        if (quoted && *c == '"')
+            c++; // "" stands for one quote
+    }
+    record->name[nameLength] = '\0';
+    record->hash = ownerNameHash(record->name);
+    record->owner = NULL;
+    return 1;
+}
+
+static void importParseTask(int index, void *ctx) {
+
+    ImportChunk *chunk = &((ImportChunk *)ctx)[index];
+    const char *line = chunk->start;
+    while (line < chunk->end) {
+        const char *eol = memchr(line, '\n', (size_t)(chunk->end - line));
+        if (!eol)
+            eol = chunk->end;
+        if (chunk->count == chunk->capacity) {
+            int capacity = chunk->capacity ? chunk->capacity * 2 : 64;
+            ImportRecord *grown = realloc(chunk->records, (size_t)capacity * sizeof(ImportRecord));
+            if (!grown) {
+                chunk->failed = 1;
+                return;
+            }
+            chunk->records = grown;
+            chunk->capacity = capacity;
+        }
+
+        int status = parseImportLine(line, eol, &chunk->records[chunk->count]);
+        if (status == -2) {
+            chunk->failed = 1;
+            return;
+        }
+        if (status > 0) {
+            chunk->count++;
+        } else if (status < 0) {
+            if (!chunk->firstBad)
+                chunk->firstBad = line;
+            chunk->badLines++;
+        }
+        line = eol < chunk->end ? eol + 1 : chunk->end;
+    }
+}
+
+// IDs come off the bitmap in ascending order, so the tree is built balanced directly
+static void importBuildTask(int index, void *ctx) {
+
+    ImportBuild *build = ctx;
+    ImportRecord *record = build->records[index];
+    PokemonNode *nodes[POKEDEX_SIZE];
+    int count = 0;
+    for (int word = 0; word < IMPORT_ID_WORDS; word++) {
+        for (uint32_t bits = record->ids[word]; bits; bits &= bits - 1) {
+            int id = word * 32 + __builtin_ctz(bits) + 1;
+            nodes[count] = createPokemonNode(&pokedex[id - 1]);
+            if (!nodes[count]) {
+                while (count > 0)
+                    freePokemonNode(nodes[--count]);
+                __atomic_store_n(&build->failed, 1, __ATOMIC_RELAXED);
+                return;
+            }
+            count++;
+        }
+    }
+
+    PokemonNode *root = buildBalancedTree(nodes, count);
+    record->owner = createOwner(record->name, root);
+    if (!record->owner) {
+        freePokemonTree(root);
+        __atomic_store_n(&build->failed, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    record->name = NULL; // createOwner freed it
+}
+
+// Drop names already registered or seen earlier in the file; returns the kept count
+static int dedupeImportRecords(ImportRecord **records, int count, ImportReport *report) {
+
+    size_t size = 16;
+    while (size < (size_t)count * 2)
+        size *= 2;
+    ImportRecord **seen = calloc(size, sizeof(ImportRecord *));
+    if (!seen)
+        return -1;
+
+    int kept = 0;
+    for (int i = 0; i < count; i++) {
+        ImportRecord *record = records[i];
+        int duplicate = findOwnerByName(record->name) != NULL;
+        size_t slot = record->hash & (size - 1);
+        while (!duplicate && seen[slot]) {
+            duplicate = seen[slot]->hash == record->hash && strcmp(seen[slot]->name, record->name) == 0;
+            slot = (slot + 1) & (size - 1);
+        }
+        if (duplicate) {
+            free(record->name);
+            record->name = NULL;
+            report->duplicates++;
+            continue;
+        }
+        seen[slot] = record;
+        records[kept++] = record;
+    }
+    free(seen);
+    return kept;
+}
+
+// Dedupe, build the trees in parallel and link the owners in one batch, in array order.
+// Returns 0, or -1 if out of memory (nothing linked). Names left in records are the caller's.
+static int addImportedOwners(ImportRecord **records, int count, ImportReport *report) {
+
+    int kept = dedupeImportRecords(records, count, report);
+    if (kept <= 0)
+        return kept;
+
+    ImportBuild build = {records, 0};
+    parallelFor(kept, 1 + kept / IMPORT_OWNERS_PER_THREAD, importBuildTask, &build);
+    if (build.failed) {
+        for (int i = 0; i < kept; i++) {
+            if (records[i]->owner)
+                freeOwnerNode(records[i]->owner);
+        }
+        return -1;
+    }
+    // The records array is reused for the owner pointers
+    OwnerNode **owners = (OwnerNode **)records;
+    for (int i = 0; i < kept; i++)
+        owners[i] = records[i]->owner;
+    linkOwnersBatch(owners, (size_t)kept);
+    report->imported = kept;
+    return 0;
+}
+
+/**
+ * @brief Create owners from a file of "name,species,species,..." lines.
+ * @param path file to read
+ * @param report receives the counts
+ * @return 0 on success, -1 if the file can't be read or memory runs out (nothing imported)
+ * Why we made it: Onboarding thousands of trainers one menu prompt at a time is too
+ * slow. The file is mapped and parsed in parallel chunks, and the owners are linked
+ * in one batch.
+ */
+int importOwnersFromFile(const char *path, ImportReport *report) {
+
+    memset(report, 0, sizeof(*report));
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    size_t size = (size_t)st.st_size;
+    if (size == 0) {
+        close(fd);
+        return 0;
+    }
+    const char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return -1;
+
+    int chunkCount = PARALLEL_THREADS * IMPORT_CHUNKS_PER_THREAD;
+    if ((size_t)chunkCount > size / IMPORT_MIN_CHUNK)
+        chunkCount = (int)(size / IMPORT_MIN_CHUNK) + 1;
+    ImportChunk *chunks = calloc((size_t)chunkCount, sizeof(ImportChunk));
+    if (!chunks) {
+        munmap((void *)data, size);
+        return -1;
+    }
+    // Every chunk but the first starts just past a newline
+    const char *end = data + size;
+    const char *start = data;
+    for (int i = 0; i < chunkCount; i++) {
+        const char *chunkEnd = end;
+        if (i < chunkCount - 1) {
+            const char *cut = data + size / (size_t)chunkCount * (size_t)(i + 1);
+            if (cut < start)
+                cut = start; // The previous chunk's last line ran past this cut
+            const char *eol = memchr(cut, '\n', (size_t)(end - cut));
+            chunkEnd = eol ? eol + 1 : end;
+        }
+        chunks[i].start = start;
+        chunks[i].end = chunkEnd;
+        start = chunkEnd;
+    }
+    parallelFor(chunkCount, chunkCount, importParseTask, chunks);
+
+    int total = 0;
+    int failed = 0;
+    for (int i = 0; i < chunkCount; i++) {
+        total += chunks[i].count;
+        report->badLines += chunks[i].badLines;
+        failed |= chunks[i].failed;
+        if (!report->firstBadLine && chunks[i].firstBad) {
+            long line = 1;
+            for (const char *c = data; (c = memchr(c, '\n', (size_t)(chunks[i].firstBad - c))); c++)
+                line++;
+            report->firstBadLine = line;
+        }
+    }
+
+    ImportRecord **records = malloc((size_t)(total > 0 ? total : 1) * sizeof(ImportRecord *));
+    int result = -1;
+    if (records && !failed) {
+        int n = 0;
+        for (int i = 0; i < chunkCount; i++) {
+            for (int j = 0; j < chunks[i].count; j++)
+                records[n++] = &chunks[i].records[j];
+        }
+        result = addImportedOwners(records, total, report);
+    }
+
+    // Names that never reached createOwner (bad runs, duplicates are already freed)
+    for (int i = 0; i < chunkCount; i++) {
+        for (int j = 0; j < chunks[i].count; j++)
+            free(chunks[i].records[j].name);
+        free(chunks[i].records);
+    }
+    free(chunks);
+    free(records);
+    munmap((void *)data, size);
+    if (result < 0)
+        memset(report, 0, sizeof(*report));
+    return result;
+}
+
+/**
+ * @brief Menu entry: import owners from a CSV file.
+ */
+void importOwnersMenu(void) {
+
+    printf("=== Import Owners ===\n");
+    printf("Enter file name: ");
+    char *path = getDynamicInput();
+    if (!path || path[0] == '\0') {
+        printf("Invalid file name.\n");
+        free(path);
+        return;
+    }
+
+    ImportReport report;
+    if (importOwnersFromFile(path, &report) < 0) {
+        printf("Cannot import '%s'.\n", path);
+        free(path);
+        return;
+    }
+    printf("Imported %d owners (%d duplicate names skipped, %d bad lines).\n", report.imported,
+           report.duplicates, report.badLines);
+    if (report.firstBadLine)
+        printf("First bad line: %ld\n", report.firstBadLine);
+    free(path);
+}
+
+/* ------------------------------------------------------------
+   30) Compressed Snapshots (Bitmap or Delta-Varint per Owner)
+   ------------------------------------------------------------ */
+
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BUFFER (1 << 20)
+#define SNAPSHOT_MIN_OWNER 3 // Name length, one name byte, tag
+#define VARINT_MAX 10        // Bytes in the longest 64-bit varint
+
+static const char snapshotMagic[4] = {'P', 'K', 'D', 'X'};
+
+static size_t putVarint(unsigned char *out, size_t value) {
+
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (unsigned char)value;
+    return n;
+}
+
+// Read one varint from [*at, end); 0 if it runs off the end or is too long
+static int getVarint(const unsigned char **at, const unsigned char *end, size_t *value) {
+
+    size_t result = 0;
+    for (int shift = 0; *at < end && shift < 64; shift += 7) {
+        unsigned char byte = *(*at)++;
+        result |= (size_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Encode a Pokedex as a tag plus bitmap or gap list, whichever is shorter; returns the length
+static size_t encodeSnapshotPokedex(PokemonNode *root, unsigned char *out) {
+
+    // In-order with a fixed stack, like flattenOwnerTask: IDs come out ascending
+    int ids[POKEDEX_SIZE];
+    int count = 0;
+    PokemonNode *stack[POKEDEX_SIZE];
+    int depth = 0;
+    PokemonNode *current = root;
+    while (current != NULL || depth > 0) {
+        while (current != NULL) {
+            stack[depth++] = current;
+            current = current->left;
+        }
+        current = stack[--depth];
+        if (!current->dead)
+            ids[count++] = current->data->id;
+        current = current->right;
+    }
+
+    size_t length = 1;
+    int previous = 0;
+    out[0] = (unsigned char)(count + 1);
+    for (int i = 0; i < count; i++) {
+        length += putVarint(out + length, (size_t)(ids[i] - previous));
+        previous = ids[i];
+    }
+    if (length <= 1 + SNAPSHOT_BITMAP_BYTES)
+        return length;
+
+    out[0] = 0;
+    memset(out + 1, 0, SNAPSHOT_BITMAP_BYTES);
+    for (int i = 0; i < count; i++)
+        out[1 + (ids[i] - 1) / 8] |= (unsigned char)(1u << ((ids[i] - 1) % 8));
+    return 1 + SNAPSHOT_BITMAP_BYTES;
+}
 
-    if (direct == 'F' || direct == 'f') {
-        for (int i = 1; i <= count; i++) {
-            printf("[%d] %s", i, cur->ownerName);
-			cur = cur->next;
-		}
-	} else if (direct == 'B' || direct == 'b') {
-        for (int i = 1; i <= count; i++) {
-            printf("[%d] %s", i, cur->ownerName);
-			cur = cur->prev;
-		}
-	}
+/**
+ * @brief Write every owner's name and Pokedex to a snapshot stream.
+ * @param out destination stream
+ * @return bytes written, or -1 if writing failed
+ * Why we made it: Species IDs are small and dense, so millions of owners fit in a
+ * file small enough to stay in the page cache.
+ */
+long saveOwnersSnapshot(FILE *out) {
+
+    unsigned char header[sizeof(snapshotMagic) + 1 + VARINT_MAX];
+    memcpy(header, snapshotMagic, sizeof(snapshotMagic));
+    header[sizeof(snapshotMagic)] = SNAPSHOT_VERSION;
+    size_t length = sizeof(snapshotMagic) + 1;
+    length += putVarint(header + length, ownerCount);
+    fwrite(header, 1, length, out);
+    long written = (long)length;
+
+    // Room for a full gap list, which is written before the bitmap is considered
+    unsigned char encoded[1 + POKEDEX_SIZE * 2];
+    OwnerCursor cursor;
+    ownerCursorStart(&cursor, OWNERS_FORWARD);
+    for (OwnerNode *cur = ownerCursorNext(&cursor); cur; cur = ownerCursorNext(&cursor)) {
+        size_t nameLength = strlen(cur->ownerName);
+        length = putVarint(header, nameLength);
+        fwrite(header, 1, length, out);
+        fwrite(cur->ownerName, 1, nameLength, out);
+        written += (long)(length + nameLength);
+
+        length = encodeSnapshotPokedex(cur->pokedexRoot, encoded);
+        fwrite(encoded, 1, length, out);
+        written += (long)length;
+    }
+    if (fflush(out) != 0 || ferror(out))
+        return -1;
+    return written;
 }
 
-/* ------------------------------------------------------------
-   12) Cleanup All Owners at Program End
-   ------------------------------------------------------------ */
+// 0 = record filled, -1 = out of memory, -2 = corrupt. On failure record->name is NULL.
+static int decodeSnapshotOwner(const unsigned char **at, const unsigned char *end, ImportRecord *record) {
+
+    size_t nameLength;
+    record->name = NULL;
+    if (!getVarint(at, end, &nameLength) || nameLength == 0 || nameLength >= (size_t)(end - *at) ||
+        memchr(*at, '\0', nameLength))
+        return -2; // Also leaves no room for the tag
+    record->name = malloc(nameLength + 1);
+    if (!record->name)
+        return -1;
+    memcpy(record->name, *at, nameLength);
+    record->name[nameLength] = '\0';
+    *at += nameLength;
+
+    int tag = *(*at)++;
+    int ok = 1;
+    memset(record->ids, 0, sizeof(record->ids));
+    if (tag == 0) {
+        ok = end - *at >= SNAPSHOT_BITMAP_BYTES;
+        // Bits past the last species must be clear
+        if (ok && POKEDEX_SIZE % 8)
+            ok = ((*at)[SNAPSHOT_BITMAP_BYTES - 1] >> (POKEDEX_SIZE % 8)) == 0;
+        for (int i = 0; ok && i < SNAPSHOT_BITMAP_BYTES; i++)
+            record->ids[i / 4] |= (uint32_t)(*at)[i] << (8 * (i % 4));
+        if (ok)
+            *at += SNAPSHOT_BITMAP_BYTES;
+    } else {
+        int previous = 0;
+        ok = tag - 1 <= POKEDEX_SIZE;
+        for (int i = 0; ok && i < tag - 1; i++) {
+            size_t gap;
+            ok = getVarint(at, end, &gap) && gap >= 1 && gap <= (size_t)(POKEDEX_SIZE - previous);
+            if (ok) {
+                previous += (int)gap;
+                record->ids[(previous - 1) / 32] |= 1u << ((previous - 1) % 32);
+            }
+        }
+    }
+    if (!ok) {
+        free(record->name);
+        record->name = NULL;
+        return -2;
+    }
+    record->hash = ownerNameHash(record->name);
+    record->owner = NULL;
+    return 0;
+}
 
 /**
- * @brief Frees every remaining owner in the circular list, setting ownerHead = NULL.
- * Why we made it: Ensures a squeaky-clean exit with no leftover memory.
+ * @brief Add the owners stored in a snapshot file; names already taken are skipped.
+ * @param path snapshot file
+ * @param report receives the counts (badLines stays 0)
+ * @return 0 on success, -1 if the file can't be read or memory runs out, -2 if it isn't
+ * a valid snapshot (nothing loaded in either case)
+ * Why we made it: Trees are built straight from the decoded ascending IDs, with no
+ * per-ID inserts.
  */
-void freeAllOwners(void) {
+int loadOwnersSnapshot(const char *path, ImportReport *report) {
+
+    memset(report, 0, sizeof(*report));
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    size_t size = (size_t)st.st_size;
+    if (size < sizeof(snapshotMagic) + 2) {
+        close(fd);
+        return -2;
+    }
+    const unsigned char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return -1;
+
+    const unsigned char *end = data + size;
+    const unsigned char *at = data + sizeof(snapshotMagic) + 1;
+    size_t count = 0;
+    int result = -2;
+    if (memcmp(data, snapshotMagic, sizeof(snapshotMagic)) == 0 &&
+        data[sizeof(snapshotMagic)] == SNAPSHOT_VERSION && getVarint(&at, end, &count) &&
+        count <= (size_t)(end - at) / SNAPSHOT_MIN_OWNER && count <= INT_MAX)
+        result = 0;
+
+    ImportRecord *records = NULL;
+    ImportRecord **pointers = NULL;
+    size_t decoded = 0;
+    if (result == 0) {
+        records = malloc((count > 0 ? count : 1) * sizeof(ImportRecord));
+        pointers = malloc((count > 0 ? count : 1) * sizeof(ImportRecord *));
+        if (!records || !pointers)
+            result = -1;
+    }
+    while (result == 0 && decoded < count) {
+        result = decodeSnapshotOwner(&at, end, &records[decoded]);
+        if (result == 0)
+            pointers[decoded] = &records[decoded];
+        decoded++;
+    }
+    if (result == 0 && at != end)
+        result = -2; // Trailing bytes: not something we wrote
+    if (result == 0)
+        result = addImportedOwners(pointers, (int)count, report);
+
+    for (size_t i = 0; i < decoded; i++)
+        free(records[i].name);
+    free(records);
+    free(pointers);
+    munmap((void *)data, size);
+    if (result < 0)
+        memset(report, 0, sizeof(*report));
+    return result;
+}
 
-    if (ownerHead == NULL) {
+/**
+ * @brief Menu entry: save all owners to a snapshot file.
+ */
+void saveSnapshotMenu(void) {
+
+    printf("=== Save Snapshot ===\n");
+    printf("Enter file name: ");
+    char *path = getDynamicInput();
+    if (!path || path[0] == '\0') {
+        printf("Invalid file name.\n");
+        free(path);
         return;
     }
 
-    OwnerNode *cur = ownerHead;
-    OwnerNode* next;
+    FILE *out = fopen(path, "wb");
+    if (!out) {
+        printf("Cannot open '%s' for writing.\n", path);
+        free(path);
+        return;
+    }
+    setvbuf(out, NULL, _IOFBF, SNAPSHOT_BUFFER);
+    long bytes = saveOwnersSnapshot(out);
+    if (fclose(out) != 0)
+        bytes = -1;
+    if (bytes < 0)
+        printf("Writing '%s' failed.\n", path);
+    else
+        printf("Saved %zu owners to %s (%ld bytes).\n", ownerCount, path, bytes);
+    free(path);
+}
 
-    do {
-        next = cur->next;
-        freeOwnerNode(cur);
-        cur = next;
-    } while (cur != ownerHead);
+/**
+ * @brief Menu entry: load owners from a snapshot file.
+ */
+void loadSnapshotMenu(void) {
+
+    printf("=== Load Snapshot ===\n");
+    printf("Enter file name: ");
+    char *path = getDynamicInput();
+    if (!path || path[0] == '\0') {
+        printf("Invalid file name.\n");
+        free(path);
+        return;
+    }
 
-    ownerHead = NULL;
+    ImportReport report;
+    int result = loadOwnersSnapshot(path, &report);
+    if (result == -2)
+        printf("'%s' is not a valid snapshot.\n", path);
+    else if (result < 0)
+        printf("Cannot read '%s'.\n", path);
+    else
+        printf("Loaded %d owners (%d duplicate names skipped).\n", report.imported, report.duplicates);
+    free(path);
 }
 
+/* ------------------------------------------------------------
+   31) Benchmarks (--bench)
+   ------------------------------------------------------------ */
 
-// --------------------------------------------------------------
-// Display Menu
-// --------------------------------------------------------------
-void displayMenu(OwnerNode *owner)
-{
-    if (!owner->pokedexRoot)
-    {
-        printf("Pokedex is empty.\n");
-        return;
-    }
+#define BENCH_ROUNDS 20000
 
-    printf("Display:\n");
-    printf("1. BFS (Level-Order)\n");
-    printf("2. Pre-Order\n");
-    printf("3. In-Order\n");
-    printf("4. Post-Order\n");
-    printf("5. Alphabetical (by name)\n");
+static double benchNow(void) {
 
-    int choice = readIntSafe("Your choice: ");
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
 
-    switch (choice)
-    {
-    case 1:
-        displayBFS(owner->pokedexRoot);
-        break;
-    case 2:
-        preOrderTraversal(owner->pokedexRoot);
-        break;
-    case 3:
-        inOrderTraversal(owner->pokedexRoot);
-        break;
-    case 4:
-        postOrderTraversal(owner->pokedexRoot);
-        break;
-    case 5:
-        displayAlphabetical(owner->pokedexRoot);
-        break;
-    default:
-        printf("Invalid choice.\n");
+// Every species once: balanced as the bulk paths build it, or a right-leaning list as
+// sequential inserts leave it
+static PokemonNode *benchTree(int listShaped) {
+
+    PokemonNode *nodes[POKEDEX_SIZE];
+    for (int i = 0; i < POKEDEX_SIZE; i++) {
+        nodes[i] = createPokemonNode(&pokedex[i]);
+        if (!nodes[i]) {
+            while (i-- > 0)
+                freePokemonNode(nodes[i]);
+            return NULL;
+        }
     }
+    if (!listShaped)
+        return buildBalancedTree(nodes, POKEDEX_SIZE);
+    for (int i = 0; i + 1 < POKEDEX_SIZE; i++)
+        nodes[i]->right = nodes[i + 1];
+    return nodes[0];
 }
 
-// --------------------------------------------------------------
-// Sub-menu for existing Pokedex
-// --------------------------------------------------------------
-void enterExistingPokedexMenu(void)
-{
-    // list owners
-    printf("\nExisting Pokedexes:\n");
+static TraverseResult benchVisitCount(PokemonNode *node, void *ctx) {
 
-    int cnt = printAndCountOwners();
+    *(long *)ctx += node->data->id;
+    return TRAVERSE_CONTINUE;
+}
 
-    int choice = readIntSafe("Choose a Pokedex by number:");
-    if (choice > cnt)
-        return;
-    OwnerNode *cur = findOwnerByNum(choice);
-    if (!cur)
+// The recursive walkers the iterative ones replaced, kept here as the baseline
+static void benchPreOrderRecursive(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx) {
+
+    if (root == NULL)
         return;
+    if (!root->dead)
+        visit(root, ctx);
+    benchPreOrderRecursive(root->left, visit, ctx);
+    benchPreOrderRecursive(root->right, visit, ctx);
+}
 
-    printf("\nEntering %s's Pokedex...\n", cur->ownerName);
+static void benchInOrderRecursive(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx) {
 
-    int subChoice;
-    do
-    {
-        printf("\n-- %s's Pokedex Menu --\n", cur->ownerName);
-        printf("1. Add Pokemon\n");
-        printf("2. Display Pokedex\n");
-        printf("3. Release Pokemon (by ID)\n");
-        printf("4. Pokemon Fight!\n");
-        printf("5. Evolve Pokemon\n");
-        printf("6. Back to Main\n");
+    if (root == NULL)
+        return;
+    benchInOrderRecursive(root->left, visit, ctx);
+    if (!root->dead)
+        visit(root, ctx);
+    benchInOrderRecursive(root->right, visit, ctx);
+}
 
-        subChoice = readIntSafe("Your choice: ");
+static void benchPostOrderRecursive(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx) {
 
-        switch (subChoice)
-        {
-        case 1:
-            addPokemon(cur);
+    if (root == NULL)
+        return;
+    benchPostOrderRecursive(root->left, visit, ctx);
+    benchPostOrderRecursive(root->right, visit, ctx);
+    if (!root->dead)
+        visit(root, ctx);
+}
+
+typedef enum {
+    BENCH_PRE_RECURSIVE,
+    BENCH_PRE_ITERATIVE,
+    BENCH_IN_RECURSIVE,
+    BENCH_IN_ITERATIVE,
+    BENCH_IN_MORRIS,
+    BENCH_POST_RECURSIVE,
+    BENCH_POST_ITERATIVE,
+    BENCH_WALKER_COUNT
+} BenchWalker;
+
+static const char *const benchWalkerNames[BENCH_WALKER_COUNT] = {
+    "pre-order recursive", "pre-order iterative", "in-order recursive", "in-order iterative",
+    "in-order Morris", "post-order recursive", "post-order iterative"};
+
+// Nanoseconds per visited node for BENCH_ROUNDS walks of root; *sum keeps the work observable
+static double benchWalk(BenchWalker walker, PokemonNode *root, long *sum) {
+
+    double begin = benchNow();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        switch (walker) {
+        case BENCH_PRE_RECURSIVE:
+            benchPreOrderRecursive(root, benchVisitCount, sum);
             break;
-        case 2:
-            displayMenu(cur);
+        case BENCH_PRE_ITERATIVE:
+            preOrderGenericCtx(root, benchVisitCount, sum);
             break;
-        case 3:
-            freePokemon(cur);
+        case BENCH_IN_RECURSIVE:
+            benchInOrderRecursive(root, benchVisitCount, sum);
             break;
-        case 4:
-            pokemonFight(cur);
+        case BENCH_IN_ITERATIVE:
+            inOrderGenericCtx(root, benchVisitCount, sum);
             break;
-        case 5:
-            evolvePokemon(cur);
+        case BENCH_IN_MORRIS:
+            inOrderMorrisCtx(root, benchVisitCount, sum);
             break;
-        case 6:
-            printf("Back to Main Menu.\n");
+        case BENCH_POST_RECURSIVE:
+            benchPostOrderRecursive(root, benchVisitCount, sum);
             break;
         default:
-            printf("Invalid choice.\n");
+            postOrderGenericCtx(root, benchVisitCount, sum);
+            break;
         }
-    } while (subChoice != 6);
+    }
+    return (benchNow() - begin) * 1e9 / ((double)BENCH_ROUNDS * POKEDEX_SIZE);
 }
 
-// --------------------------------------------------------------
-// Main Menu
-// --------------------------------------------------------------
-void mainMenu()
-{
-    int choice;
-    do
-    {
-        printf("\n=== Main Menu ===\n");
-        printf("1. New Pokedex\n");
-        printf("2. Existing Pokedex\n");
-        printf("3. Delete a Pokedex\n");
-        printf("4. Merge Pokedexes\n");
-        printf("5. Sort Owners by Name\n");
-        printf("6. Print Owners in a direction X times\n");
-        printf("7. Exit\n");
-        choice = readIntSafe("Your choice: ");
+static int benchTraversals(void) {
 
-        switch (choice)
-        {
-        case 1:
-            openPokedexMenu();
-            break;
-        case 2:
-            enterExistingPokedexMenu();
-            break;
-        case 3:
-            deletePokedex();
-            break;
-        case 4:
-            mergePokedexMenu();
-            break;
-        case 5:
-            sortOwners();
-            break;
-        case 6:
-            printOwnersCircular();
-            break;
-        case 7:
-            printf("Goodbye!\n");
-            break;
-        default:
-            printf("Invalid.\n");
+    PokemonNode *balanced = benchTree(0);
+    PokemonNode *list = benchTree(1);
+    if (!balanced || !list) {
+        freePokemonTree(balanced);
+        freePokemonTree(list);
+        return 1;
+    }
+
+    long sum = 0;
+    printf("Traversals: %d nodes, %d rounds, ns per node\n", POKEDEX_SIZE, BENCH_ROUNDS);
+    printf("%-22s %10s %12s\n", "", "balanced", "list-shaped");
+    for (int w = 0; w < BENCH_WALKER_COUNT; w++) {
+        double onBalanced = benchWalk((BenchWalker)w, balanced, &sum);
+        double onList = benchWalk((BenchWalker)w, list, &sum);
+        printf("%-22s %10.2f %12.2f\n", benchWalkerNames[w], onBalanced, onList);
+    }
+    printf("(checksum %ld)\n", sum);
+
+    freePokemonTree(balanced);
+    freePokemonTree(list);
+    return 0;
+}
+
+// The same sum visitor as benchVisitCount, pasted into the DEFINE_*_WALK loops
+#define VISIT_BENCH_SUM(node, ctx) (*(ctx) += (node)->data->id)
+
+DEFINE_BFS_WALK(bfsSumWalk, long *, VISIT_BENCH_SUM)
+DEFINE_PREORDER_WALK(preOrderSumWalk, long *, VISIT_BENCH_SUM)
+DEFINE_INORDER_WALK(inOrderSumWalk, long *, VISIT_BENCH_SUM)
+DEFINE_POSTORDER_WALK(postOrderSumWalk, long *, VISIT_BENCH_SUM)
+
+#define BENCH_ORDER_COUNT 4
+#define BENCH_PRINT_ROUNDS (BENCH_ROUNDS / 20)
+
+static const char *const benchOrderNames[BENCH_ORDER_COUNT] = {"BFS", "pre-order", "in-order", "post-order"};
+
+// Nanoseconds per node for one order: specialized (inlined visitor) or through a function pointer
+static double benchSpecialized(int order, int specialized, int print, PokemonNode *root, long *sum) {
+
+    static void (*const sumWalks[BENCH_ORDER_COUNT])(PokemonNode *, long *) = {
+        bfsSumWalk, preOrderSumWalk, inOrderSumWalk, postOrderSumWalk};
+    static TraverseResult (*const ctxWalks[BENCH_ORDER_COUNT])(PokemonNode *, VisitNodeCtxFunc, void *) = {
+        BFSGenericCtx, preOrderGenericCtx, inOrderGenericCtx, postOrderGenericCtx};
+    static void (*const printWalks[BENCH_ORDER_COUNT])(PokemonNode *, void *) = {
+        bfsPrintWalk, preOrderPrintWalk, inOrderPrintWalk, postOrderPrintWalk};
+    static void (*const plainWalks[BENCH_ORDER_COUNT])(PokemonNode *, VisitNodeFunc) = {
+        BFSGeneric, preOrderGeneric, inOrderGeneric, postOrderGeneric};
+
+    int rounds = print ? BENCH_PRINT_ROUNDS : BENCH_ROUNDS;
+    double begin = benchNow();
+    for (int round = 0; round < rounds; round++) {
+        if (print && specialized)
+            printWalks[order](root, NULL);
+        else if (print)
+            plainWalks[order](root, printPokemonNode);
+        else if (specialized)
+            sumWalks[order](root, sum);
+        else
+            ctxWalks[order](root, benchVisitCount, sum);
+    }
+    if (print)
+        fflush(stdout);
+    return (benchNow() - begin) * 1e9 / ((double)rounds * POKEDEX_SIZE);
+}
+
+static int benchSpecializedWalkers(void) {
+
+    PokemonNode *balanced = benchTree(0);
+    PokemonNode *list = benchTree(1);
+    if (!balanced || !list) {
+        freePokemonTree(balanced);
+        freePokemonTree(list);
+        return 1;
+    }
+
+    // The display walkers print to stdout: point it at /dev/null while they run
+    double perNode[2][BENCH_ORDER_COUNT][2][2];
+    long sum = 0;
+    fflush(stdout);
+    int savedStdout = dup(STDOUT_FILENO);
+    int devNull = open("/dev/null", O_WRONLY);
+    if (savedStdout < 0 || devNull < 0) {
+        if (savedStdout >= 0)
+            close(savedStdout);
+        if (devNull >= 0)
+            close(devNull);
+        freePokemonTree(balanced);
+        freePokemonTree(list);
+        return 1;
+    }
+    for (int print = 0; print < 2; print++) {
+        if (print)
+            dup2(devNull, STDOUT_FILENO);
+        for (int order = 0; order < BENCH_ORDER_COUNT; order++) {
+            for (int specialized = 1; specialized >= 0; specialized--) {
+                perNode[print][order][specialized][0] = benchSpecialized(order, specialized, print, balanced, &sum);
+                perNode[print][order][specialized][1] = benchSpecialized(order, specialized, print, list, &sum);
+            }
         }
-    } while (choice != 7);
+    }
+    dup2(savedStdout, STDOUT_FILENO);
+    close(savedStdout);
+    close(devNull);
+
+    printf("\nSpecialized vs function-pointer walkers: ns per node (balanced / list-shaped)\n");
+    printf("%-18s %20s %20s\n", "", "DEFINE_*_WALK", "function pointer");
+    for (int print = 0; print < 2; print++) {
+        for (int order = 0; order < BENCH_ORDER_COUNT; order++) {
+            char label[32];
+            snprintf(label, sizeof(label), "%s %s", benchOrderNames[order], print ? "print" : "sum");
+            printf("%-18s %9.2f / %8.2f %9.2f / %8.2f\n", label,
+                   perNode[print][order][1][0], perNode[print][order][1][1],
+                   perNode[print][order][0][0], perNode[print][order][0][1]);
+        }
+    }
+    printf("(checksum %ld)\n", sum);
+
+    freePokemonTree(balanced);
+    freePokemonTree(list);
+    return 0;
+}
+
+#define BENCH_ENGINE_COPIES 200
+#define BENCH_ENGINE_PASSES 5
+
+static const int benchSizes[] = {8, 32, 64, 128, POKEDEX_SIZE};
+
+// Engines walk with a plain VisitNodeFunc, so the sum has to live outside
+static long benchVisitTotal;
+
+static void benchVisitSum(PokemonNode *node) {
+
+    benchVisitTotal += node->data->id;
+}
+
+// Every species ID once, in an order fixed by *seed so every engine sees the same one
+static void benchShuffle(int *ids, unsigned int *seed) {
+
+    for (int i = 0; i < POKEDEX_SIZE; i++)
+        ids[i] = i + 1;
+    for (int i = POKEDEX_SIZE - 1; i > 0; i--) {
+        int j = rand_r(seed) % (i + 1);
+        int swap = ids[i];
+        ids[i] = ids[j];
+        ids[j] = swap;
+    }
+}
+
+// One size of the sweep: many copies per phase so the clock reads don't dominate
+static int benchEngineSize(const PokedexEngine *engine, int size, double perOp[4]) {
+
+    void *copies[BENCH_ENGINE_COPIES];
+    int ids[POKEDEX_SIZE];
+    unsigned int seed = 1;
+    long found = 0;
+    memset(perOp, 0, 4 * sizeof(double));
+
+    for (int pass = 0; pass < BENCH_ENGINE_PASSES; pass++) {
+        benchShuffle(ids, &seed);
+        for (int c = 0; c < BENCH_ENGINE_COPIES; c++) {
+            copies[c] = engine->create();
+            if (!copies[c]) {
+                while (c-- > 0)
+                    engine->destroy(copies[c]);
+                return 1;
+            }
+        }
+
+        double begin = benchNow();
+        for (int c = 0; c < BENCH_ENGINE_COPIES; c++)
+            for (int i = 0; i < size; i++)
+                engine->insert(copies[c], &pokedex[ids[i] - 1]);
+        double inserted = benchNow();
+        // Stride 7 is coprime to every size, so each ID is probed once in a scrambled order
+        for (int c = 0; c < BENCH_ENGINE_COPIES; c++)
+            for (int i = 0; i < size; i++)
+                found += engine->search(copies[c], ids[(i * 7) % size]) != NULL;
+        double searched = benchNow();
+        for (int c = 0; c < BENCH_ENGINE_COPIES; c++)
+            engine->traverse(copies[c], ORDER_IN, benchVisitSum);
+        double walked = benchNow();
+        for (int c = 0; c < BENCH_ENGINE_COPIES; c++)
+            for (int i = 0; i < size; i++)
+                engine->remove(copies[c], ids[i]);
+        double removed = benchNow();
+
+        for (int c = 0; c < BENCH_ENGINE_COPIES; c++)
+            engine->destroy(copies[c]);
+        perOp[0] += inserted - begin;
+        perOp[1] += searched - inserted;
+        perOp[2] += walked - searched;
+        perOp[3] += removed - walked;
+    }
+
+    double ops = (double)BENCH_ENGINE_COPIES * BENCH_ENGINE_PASSES * size;
+    for (int i = 0; i < 4; i++)
+        perOp[i] = perOp[i] * 1e9 / ops;
+    // Every probed ID was inserted, so anything else means the engine is broken
+    return found != (long)BENCH_ENGINE_PASSES * BENCH_ENGINE_COPIES * size;
+}
+
+static int benchEngines(void) {
+
+    printf("\nEngines by size (random insert order): ns per insert / search / in-order node / remove\n");
+    printf("%-8s %5s %9s %9s %9s %9s\n", "engine", "size", "insert", "search", "in-order", "remove");
+    for (size_t e = 0; e < sizeof(pokedexEngines) / sizeof(pokedexEngines[0]); e++) {
+        const PokedexEngine *engine = &pokedexEngines[e];
+        for (size_t s = 0; s < sizeof(benchSizes) / sizeof(benchSizes[0]); s++) {
+            double perOp[4];
+            if (benchEngineSize(engine, benchSizes[s], perOp) != 0)
+                return 1;
+            printf("%-8s %5d %9.2f %9.2f %9.2f %9.2f\n", engine->name, benchSizes[s],
+                   perOp[0], perOp[1], perOp[2], perOp[3]);
+        }
+    }
+    printf("(checksum %ld)\n", benchVisitTotal);
+    return 0;
+}
+
+#define BENCH_ZIPF_QUERIES 200000
+#define BENCH_ZIPF_PASSES 5
+
+// Species by popularity for the skewed workload: Pikachu and the starters first
+static const int benchHotSpecies[] = {25, 1, 4, 7, 133, 150};
+
+// Query IDs drawn from Zipf (s = 1) over popularity ranks, or uniformly when !skewed
+static void benchZipfQueries(int *queries, int count, int skewed, unsigned int *seed) {
+
+    int byRank[POKEDEX_SIZE];
+    int hot = (int)(sizeof(benchHotSpecies) / sizeof(benchHotSpecies[0]));
+    benchShuffle(byRank, seed);
+    for (int h = 0; h < hot; h++) {
+        for (int i = h; i < POKEDEX_SIZE; i++) {
+            if (byRank[i] == benchHotSpecies[h]) {
+                byRank[i] = byRank[h];
+                byRank[h] = benchHotSpecies[h];
+                break;
+            }
+        }
+    }
+
+    // Rank r has weight 1/r; inverse-CDF sampling with a binary search per query
+    double cumulative[POKEDEX_SIZE];
+    double total = 0;
+    for (int r = 0; r < POKEDEX_SIZE; r++) {
+        total += skewed ? 1.0 / (r + 1) : 1.0;
+        cumulative[r] = total;
+    }
+    for (int q = 0; q < count; q++) {
+        double u = (double)rand_r(seed) / ((double)RAND_MAX + 1) * total;
+        int lo = 0, hi = POKEDEX_SIZE - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (cumulative[mid] <= u)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        queries[q] = byRank[lo];
+    }
+}
+
+// Nanoseconds per lookup over every query, on a full Pokedex inserted in random or
+// ascending ID order (the latter leaves a plain BST list-shaped)
+static int benchZipfEngine(const PokedexEngine *engine, const int *queries, int ascending,
+                           double *perLookup) {
+
+    int ids[POKEDEX_SIZE];
+    unsigned int seed = 3;
+    benchShuffle(ids, &seed);
+    for (int i = 0; ascending && i < POKEDEX_SIZE; i++)
+        ids[i] = i + 1;
+    void *dex = engine->create();
+    if (!dex)
+        return 1;
+    for (int i = 0; i < POKEDEX_SIZE; i++) {
+        if (engine->insert(dex, &pokedex[ids[i] - 1]) < 0) {
+            engine->destroy(dex);
+            return 1;
+        }
+    }
+
+    long found = 0;
+    double begin = benchNow();
+    for (int pass = 0; pass < BENCH_ZIPF_PASSES; pass++)
+        for (int q = 0; q < BENCH_ZIPF_QUERIES; q++)
+            found += engine->search(dex, queries[q]) != NULL;
+    *perLookup = (benchNow() - begin) * 1e9 / ((double)BENCH_ZIPF_PASSES * BENCH_ZIPF_QUERIES);
+    engine->destroy(dex);
+    return found != (long)BENCH_ZIPF_PASSES * BENCH_ZIPF_QUERIES;
+}
+
+static int benchZipf(void) {
+
+    int *uniform = malloc(BENCH_ZIPF_QUERIES * sizeof(int));
+    int *skewed = malloc(BENCH_ZIPF_QUERIES * sizeof(int));
+    if (!uniform || !skewed) {
+        free(uniform);
+        free(skewed);
+        return 1;
+    }
+    unsigned int seed = 5;
+    benchZipfQueries(uniform, BENCH_ZIPF_QUERIES, 0, &seed);
+    benchZipfQueries(skewed, BENCH_ZIPF_QUERIES, 1, &seed);
+
+    printf("\nLookups on a full Pokedex: ns per lookup (random / ascending insert order)\n");
+    printf("%-8s %20s %20s\n", "engine", "uniform", "Zipf s=1");
+    int failed = 0;
+    for (size_t e = 0; e < sizeof(pokedexEngines) / sizeof(pokedexEngines[0]) && !failed; e++) {
+        double perLookup[2][2];
+        const PokedexEngine *engine = &pokedexEngines[e];
+        for (int ascending = 0; ascending < 2 && !failed; ascending++)
+            failed = benchZipfEngine(engine, uniform, ascending, &perLookup[0][ascending]) != 0 ||
+                     benchZipfEngine(engine, skewed, ascending, &perLookup[1][ascending]) != 0;
+        if (!failed)
+            printf("%-8s %9.2f / %8.2f %9.2f / %8.2f\n", engine->name,
+                   perLookup[0][0], perLookup[0][1], perLookup[1][0], perLookup[1][1]);
+    }
+
+    free(uniform);
+    free(skewed);
+    return failed;
+}
+
+// One request in this many releases a random species and adds it back
+#define BENCH_TRAFFIC_CHURN 10
+
+// ns per request through the owner API with lookupEngine = engine (NULL = the tree alone)
+static int benchTrafficRun(const PokedexEngine *engine, const int *queries, int ascending,
+                           double *perRequest) {
+
+    static const char benchName[] = "bench";
+    char *name = malloc(sizeof(benchName));
+    OwnerNode *owner = name ? createOwner(name, NULL) : NULL;
+    if (!owner) {
+        free(name);
+        return 1;
+    }
+    const PokedexEngine *saved = lookupEngine;
+    lookupEngine = engine;
+
+    int ids[POKEDEX_SIZE];
+    unsigned int seed = 3;
+    benchShuffle(ids, &seed);
+    for (int i = 0; i < POKEDEX_SIZE; i++)
+        addPokemonByID(owner, ascending ? i + 1 : ids[i]);
+
+    // Every species stays in the Pokedex, so every lookup must hit
+    long lookups = 0;
+    long found = 0;
+    int requests = BENCH_ZIPF_QUERIES / 2;
+    double begin = benchNow();
+    for (int pass = 0; pass < BENCH_ZIPF_PASSES; pass++) {
+        for (int r = 0; r < requests; r++) {
+            if (r % BENCH_TRAFFIC_CHURN == 0) {
+                int id = 1 + rand_r(&seed) % POKEDEX_SIZE;
+                releasePokemonByID(owner, id);
+                addPokemonByID(owner, id);
+                continue;
+            }
+            // A fight looks up both of its Pokemon
+            found += ownerFindPokemon(owner, queries[2 * r]) != NULL;
+            found += ownerFindPokemon(owner, queries[2 * r + 1]) != NULL;
+            lookups += 2;
+        }
+    }
+    *perRequest = (benchNow() - begin) * 1e9 / ((double)BENCH_ZIPF_PASSES * requests);
+
+    freeOwnerNode(owner);
+    lookupEngine = saved;
+    return found != lookups;
+}
+
+// Fight traffic the way owners see it: skewed lookups mixed with adds and releases,
+// which each engine copy absorbs in place
+static int benchOwnerTraffic(void) {
+
+    int *skewed = malloc(BENCH_ZIPF_QUERIES * sizeof(int));
+    if (!skewed)
+        return 1;
+    unsigned int seed = 7;
+    benchZipfQueries(skewed, BENCH_ZIPF_QUERIES, 1, &seed);
+
+    printf("\nFights through the owner API (Zipf s=1, 1 in %d requests releases and re-adds):\n",
+           BENCH_TRAFFIC_CHURN);
+    printf("%-8s %20s\n", "engine", "ns per request");
+    printf("%-8s %20s\n", "", "random / ascending");
+    int failed = 0;
+    size_t engines = sizeof(pokedexEngines) / sizeof(pokedexEngines[0]);
+    for (size_t e = 0; e <= engines && !failed; e++) {
+        // Row 0 is no --engine: lookups search the owner's own tree
+        const PokedexEngine *engine = e == 0 ? NULL : &pokedexEngines[e - 1];
+        double perRequest[2];
+        for (int ascending = 0; ascending < 2 && !failed; ascending++)
+            failed = benchTrafficRun(engine, skewed, ascending, &perRequest[ascending]) != 0;
+        if (!failed)
+            printf("%-8s %9.2f / %8.2f\n", engine ? engine->name : "(tree)",
+                   perRequest[0], perRequest[1]);
+    }
+
+    free(skewed);
+    return failed;
+}
+
+/**
+ * @brief Time the traversal and Pokedex engine variants against each other.
+ * @return process exit status (non-zero if the benchmark trees couldn't be built)
+ * Why we made it: Claims like "Morris costs little" or "specialized walkers are faster"
+ * should come with numbers from this machine.
+ */
+int runBench(void) {
+
+    if (benchTraversals() != 0 || benchSpecializedWalkers() != 0 || benchEngines() != 0 ||
+        benchZipf() != 0 || benchOwnerTraffic() != 0)
+        return 1;
+    return 0;
 }
 
-int main()
+int main(int argc, char *argv[])
 {
+    initSpeciesTables();
+    // --engine NAME goes first and works with every mode; "bst" is the owners' own trees
+    if (argc >= 3 && strcmp(argv[1], "--engine") == 0) {
+        lookupEngine = findPokedexEngine(argv[2]);
+        if (!lookupEngine) {
+            fprintf(stderr, "unknown engine '%s' (try bst, compact, btree or treap)\n", argv[2]);
+            return 2;
+        }
+        if (strcmp(argv[2], "bst") == 0)
+            lookupEngine = NULL;
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+    if (argc == 3 && strcmp(argv[1], "--server") == 0)
+        return runServer(argv[2]);
+    if (argc == 3 && strcmp(argv[1], "--client") == 0)
+        return runClient(argv[2]);
+    if (argc >= 3 && argc <= 5 && strcmp(argv[1], "--stress") == 0)
+        return runStress(argv[2], argc > 3 ? atoi(argv[3]) : 0, argc > 4 ? atoi(argv[4]) : 0);
+    if (argc == 2 && strcmp(argv[1], "--pipeline") == 0)
+        return runPipeline();
+    if (argc == 2 && strcmp(argv[1], "--bench") == 0)
+        return runBench();
+    if (argc != 1) {
+        fprintf(stderr, "usage: %s [--engine NAME] [--pipeline | --bench | --server SOCKET | --client SOCKET | --stress SOCKET [CLIENTS [REQUESTS]]]\n",
+                argv[0]);
+        return 2;
+    }
     mainMenu();
     freeAllOwners();
     return 0;
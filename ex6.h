@@ -2,6 +2,8 @@
 #define EX6_H
 
 #include <ctype.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -48,6 +50,8 @@ typedef struct PokemonNode
     const PokemonData *data;
     struct PokemonNode *left;
     struct PokemonNode *right;
+    int dead;                       // Tombstone: released in lazy mode, skipped by every walk
+    int refs;                       // Parent links and roots pointing here (> 1 = shared, copy before writing)
 } PokemonNode;
 
 // Linked List Node (for Owners)
@@ -55,12 +59,43 @@ typedef struct OwnerNode
 {
     char *ownerName;          // Owner's name
     PokemonNode *pokedexRoot; // Pointer to the root of the owner's Pokédex
-    struct OwnerNode *next;   // Next owner in the linked list
-    struct OwnerNode *prev;   // Previous owner in the linked list
+    struct OwnerNode *next;   // Next owner in its shard's ring
+    struct OwnerNode *prev;   // Previous owner in its shard's ring
+    struct FrozenPokedex *frozen; // Read-optimized copy of the Pokedex, NULL unless frozen
+    PokemonNode *snapshot;    // Pokedex before the last bulk change (shares nodes with it)
+    int hasSnapshot;          // 1 once a bulk change saved a snapshot (which may be empty)
+    void *engineCopy;         // The Pokedex in lookupEngine's backend (section 17), NULL until used
+    void *engineSnapshot;     // engineCopy as it was when snapshot was taken, NULL if there was none
+    int lazyRelease;          // 1 = releasing a Pokemon only leaves a tombstone
+    int deadCount;            // Tombstones since the last check (0 = none in the tree)
+    int deadCheckAt;          // Re-count the tree once deadCount reaches this
+    pthread_mutex_t lock;     // Guards everything above except the ring links (server mode)
+    int merged;               // Folded into another owner, awaiting unlink (atomic access)
+    struct ViewSlot *viewSlot; // Where its copy is published to lock-free readers (server mode)
+    struct OwnerNode *hashNext; // Next owner in the same name-index bucket
+    uint32_t nameHash;        // ownerNameHash(ownerName); low bits pick the shard
+    unsigned long listOrder;  // Rank in the numbered owner listing (smaller first)
 } OwnerNode;
 
-// Global head pointer for the linked list of owners
-OwnerNode *ownerHead = NULL;
+// Owners are spread over shards by name hash (section 24)
+#define OWNER_SHARDS 16
+
+typedef struct
+{
+    OwnerNode *head;          // Ring of this shard's owners, in listOrder
+    OwnerNode **buckets;      // Name index, chained through hashNext (NULL = scan the ring)
+    size_t bucketCount;       // Power of two
+    size_t count;
+} OwnerShard;
+
+OwnerShard ownerShards[OWNER_SHARDS];
+size_t ownerCount = 0;
+unsigned long nextListOrder = 1;
+
+// Server mode: writers (link, unlink, sort) hold it exclusively, owner lookups share it.
+// It covers every shard. Take it before any owner's lock. The interactive menus are
+// single-threaded and skip it.
+pthread_rwlock_t ownerRingLock = PTHREAD_RWLOCK_INITIALIZER;
 
 /* ------------------------------------------------------------
    1) Safe Input + Utility
@@ -89,6 +124,43 @@ char *myStrdup(const char *src);
  */
 int readIntSafe(const char *prompt);
 
+/**
+ * @brief Read a species as either a numeric ID or a name, re-prompt if invalid.
+ * @param prompt text to display
+ * @return species ID typed by the user (names are resolved case-insensitively)
+ * Why we made it: Users and scripts would rather type "Pikachu" than 25.
+ */
+int readSpeciesSafe(const char *prompt);
+
+/**
+ * @brief Look up a species ID by name, ignoring case.
+ * @param name species name like "charmander"
+ * @return matching ID, or 0 if no species has that name
+ * Why we made it: Binary search over a name-sorted index instead of strcmp over all of pokedex[].
+ */
+int findSpeciesByName(const char *name);
+
+/**
+ * @brief List species whose names start with a prefix, ignoring case.
+ * @param prefix prefix like "char"
+ * @param outIds receives matching IDs in alphabetical order
+ * @param maxOut capacity of outIds
+ * @return total number of matches (may exceed maxOut)
+ * Why we made it: Autocomplete over the species names via the startup-built trie.
+ */
+int searchSpeciesByPrefix(const char *prefix, int *outIds, int maxOut);
+
+/**
+ * @brief List species within a bounded edit distance of a (possibly misspelled) name.
+ * @param query name as typed by the user
+ * @param maxDistance largest Levenshtein distance accepted
+ * @param outIds receives matching IDs in alphabetical order
+ * @param maxOut capacity of outIds
+ * @return total number of matches (may exceed maxOut)
+ * Why we made it: "Pikachoo" should still find Pikachu.
+ */
+int fuzzySearchSpecies(const char *query, int maxDistance, int *outIds, int maxOut);
+
 /**
  * @brief Read a line from stdin, store in malloc'd buffer, trim whitespace.
  * @return pointer to the newly allocated string (caller frees)
@@ -118,9 +190,9 @@ PokemonNode *createPokemonNode(const PokemonData *data);
 
 /**
  * @brief Create an OwnerNode for the circular owners list.
- * @param ownerName the dynamically allocated name
+ * @param ownerName the dynamically allocated name (copied into the arena and freed on success)
  * @param starter BST root for the starter Pokemon
- * @return newly allocated OwnerNode*
+ * @return newly allocated OwnerNode*, or NULL (ownerName untouched) on failure
  * Why we made it: Each user is represented as an OwnerNode.
  */
 OwnerNode *createOwner(char *ownerName, PokemonNode *starter);
@@ -133,12 +205,30 @@ OwnerNode *createOwner(char *ownerName, PokemonNode *starter);
 void freePokemonNode(PokemonNode *node);
 
 /**
- * @brief Recursively free a BST of PokemonNodes.
- * @param root BST root
- * Why we made it: Clearing a user’s entire Pokedex means freeing a tree.
+ * @brief Drop one reference to a BST; nodes no other tree shares are freed.
+ * @param root BST root (may be NULL)
+ * Why we made it: Clearing a user’s entire Pokedex means freeing a tree, however degenerate,
+ * while leaving the parts an undo snapshot or a clone still uses.
  */
 void freePokemonTree(PokemonNode *root);
 
+/**
+ * @brief Take one more reference to a BST, sharing every node (O(1)).
+ * @param root BST root (may be NULL)
+ * @return root, for chaining
+ * Why we made it: Undo snapshots, clones and disjoint merges share nodes instead of copying them.
+ */
+PokemonNode *retainPokemonTree(PokemonNode *root);
+
+/**
+ * @brief Copy every node of a BST that another tree shares.
+ * @param root pointer to the BST root (updated)
+ * @return 1 on success, 0 if out of memory (the tree is still valid, just partly shared)
+ * Why we made it: Bulk operations rewrite nodes in place and relink them, which must not
+ * show through in a snapshot or a clone.
+ */
+int unsharePokemonTree(PokemonNode **root);
+
 /**
  * @brief Free an OwnerNode (including name and entire Pokedex BST).
  * @param owner pointer to the owner
@@ -154,7 +244,8 @@ void freeOwnerNode(OwnerNode *owner);
  * @brief Insert a PokemonNode into BST by ID; duplicates freed.
  * @param root pointer to BST root
  * @param newNode node to insert
- * @return updated BST root
+ * @return updated BST root (shared nodes on the path are copied; if that runs out of
+ *         memory newNode is freed and the tree is unchanged)
  * Why we made it: Standard BST insertion ignoring duplicates.
  */
 PokemonNode *insertPokemonNode(PokemonNode *root, PokemonNode *newNode);
@@ -168,11 +259,20 @@ PokemonNode *insertPokemonNode(PokemonNode *root, PokemonNode *newNode);
  */
 PokemonNode *searchPokemonBFS(PokemonNode *root, int id);
 
+/**
+ * @brief Search for a Pokemon by ID by descending the BST (O(height)).
+ * @param root BST root
+ * @param id ID to find
+ * @return pointer to found node or NULL
+ * Why we made it: Membership checks for many candidate IDs shouldn't each walk the whole tree.
+ */
+PokemonNode *searchPokemonBST(PokemonNode *root, int id);
+
 /**
  * @brief Remove node from BST by ID if found (BST removal logic).
  * @param root BST root
  * @param id ID to remove
- * @return updated BST root
+ * @return updated BST root (shared nodes on the path are copied first)
  * Why we made it: We handle special cases of a BST remove (0,1,2 children).
  */
 PokemonNode *removeNodeBST(PokemonNode *root, int id);
@@ -186,6 +286,32 @@ PokemonNode *removeNodeBST(PokemonNode *root, int id);
  */
 PokemonNode *removePokemonByID(PokemonNode *root, int id);
 
+/**
+ * @brief Link an ID-sorted array of existing nodes into a height-balanced BST.
+ * @param nodes array of node pointers sorted by ascending ID (no duplicates, none shared)
+ * @param count number of nodes in the array
+ * @return root of the rebuilt BST
+ * Why we made it: Bulk operations rebuild the tree once instead of re-inserting node by node.
+ */
+PokemonNode *buildBalancedTree(PokemonNode **nodes, int count);
+
+/**
+ * @brief Tombstone a Pokemon by ID instead of unlinking it (O(height)).
+ * @param root pointer to the BST root (updated when shared nodes on the path are copied)
+ * @param id ID to mark
+ * @return 1 if a live node was marked, 0 if not found, already dead or out of memory
+ * Why we made it: Releasing many Pokemon in a burst shouldn't restructure the tree each time.
+ */
+int markPokemonDead(PokemonNode **root, int id);
+
+/**
+ * @brief Free every tombstoned node and relink the rest into a balanced BST.
+ * @param root BST root
+ * @return updated BST root (unchanged if there was nothing to purge or no memory)
+ * Why we made it: One rebuild pays for a whole burst of lazy releases.
+ */
+PokemonNode *purgeDeadNodes(PokemonNode *root);
+
 /* ------------------------------------------------------------
    4) Generic BST Traversals (Function Pointers)
    ------------------------------------------------------------ */
@@ -195,6 +321,15 @@ PokemonNode *removePokemonByID(PokemonNode *root, int id);
 
 typedef void (*VisitNodeFunc)(PokemonNode *);
 
+// What a context-carrying visitor tells the walker after each node
+typedef enum
+{
+    TRAVERSE_CONTINUE,
+    TRAVERSE_STOP
+} TraverseResult;
+
+typedef TraverseResult (*VisitNodeCtxFunc)(PokemonNode *, void *ctx);
+
 /**
  * @brief Generic BFS traversal: call visit() on each node (level-order).
  * @param root BST root
@@ -227,6 +362,57 @@ void inOrderGeneric(PokemonNode *root, VisitNodeFunc visit);
  */
 void postOrderGeneric(PokemonNode *root, VisitNodeFunc visit);
 
+/**
+ * @brief In-order traversal with O(1) extra space (Morris threading) and early exit.
+ * @param root BST root
+ * @param visit callback receiving each node and ctx (must not modify the tree)
+ * @param ctx caller data handed to every visit() call
+ * @return TRAVERSE_STOP if visit() ended the walk early, else TRAVERSE_CONTINUE
+ * Why we made it: No stack at all, so nothing to allocate and nothing to fail; the tree
+ * is temporarily threaded and restored as we go, so no one else may read it meanwhile.
+ */
+TraverseResult inOrderMorrisCtx(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx);
+
+/**
+ * @brief BFS traversal with a user context; stops as soon as visit() says so.
+ * @param root BST root
+ * @param visit callback receiving each node and ctx
+ * @param ctx caller data handed to every visit() call
+ * @return TRAVERSE_STOP if visit() ended the walk early, else TRAVERSE_CONTINUE
+ * Why we made it: Searches and aggregations need state and an early exit, not globals.
+ */
+TraverseResult BFSGenericCtx(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx);
+
+/**
+ * @brief Pre-order traversal (Root-Left-Right) with a user context and early exit.
+ * @param root BST root
+ * @param visit callback receiving each node and ctx
+ * @param ctx caller data handed to every visit() call
+ * @return TRAVERSE_STOP if visit() ended the walk early, else TRAVERSE_CONTINUE
+ * Why we made it: Same as BFSGenericCtx, in depth-first order.
+ */
+TraverseResult preOrderGenericCtx(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx);
+
+/**
+ * @brief In-order traversal (Left-Root-Right) with a user context and early exit.
+ * @param root BST root
+ * @param visit callback receiving each node and ctx
+ * @param ctx caller data handed to every visit() call
+ * @return TRAVERSE_STOP if visit() ended the walk early, else TRAVERSE_CONTINUE
+ * Why we made it: Ascending-ID walks that can stop once they have what they need.
+ */
+TraverseResult inOrderGenericCtx(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx);
+
+/**
+ * @brief Post-order traversal (Left-Right-Root) with a user context and early exit.
+ * @param root BST root
+ * @param visit callback receiving each node and ctx
+ * @param ctx caller data handed to every visit() call
+ * @return TRAVERSE_STOP if visit() ended the walk early, else TRAVERSE_CONTINUE
+ * Why we made it: Children-before-parent walks with state and an early exit.
+ */
+TraverseResult postOrderGenericCtx(PokemonNode *root, VisitNodeCtxFunc visit, void *ctx);
+
 /**
  * @brief Print one PokemonNode’s data: ID, Name, Type, HP, Attack, Evolve?
  * @param node pointer to the node
@@ -234,6 +420,14 @@ void postOrderGeneric(PokemonNode *root, VisitNodeFunc visit);
  */
 void printPokemonNode(PokemonNode *node);
 
+/**
+ * @brief Write one PokemonNode's data in the printPokemonNode format.
+ * @param out stream to write to
+ * @param node pointer to the node
+ * Why we made it: Server replies need the same line, just not on stdout.
+ */
+void writePokemonNode(FILE *out, const PokemonNode *node);
+
 /* ------------------------------------------------------------
    5) Display Methods (BFS, Pre, In, Post, Alphabetical)
    ------------------------------------------------------------ */
@@ -263,17 +457,28 @@ void destroyNodeArray(NodeArray *na);
  * @brief Add a PokemonNode pointer to NodeArray, realloc if needed.
  * @param na pointer to NodeArray
  * @param node pointer to the node
+ * @return 1 if added, 0 if the array couldn't grow (na is left unchanged)
  * Why we made it: We want a dynamic list of BST nodes for sorting.
  */
-void addNode(NodeArray *na, PokemonNode *node);
+int addNode(NodeArray *na, PokemonNode *node);
 
 /**
- * @brief Recursively collect all nodes from the BST into a NodeArray.
+ * @brief Collect all nodes from the BST into a NodeArray, in ID order.
  * @param root BST root
  * @param na pointer to NodeArray
- * Why we made it: We gather everything for qsort.
+ * @return 1 if every node was collected, 0 if the array ran out of memory
+ * Why we made it: Bulk operations work on the nodes as one sorted array; the Morris walk
+ * needs no stack, so with the array sized up front nothing can fail.
+ */
+int collectAll(PokemonNode *root, NodeArray *na);
+
+/**
+ * @brief Count the nodes of a BST.
+ * @param root BST root
+ * @return number of nodes
+ * Why we made it: Lets bulk operations size their arrays exactly up front.
  */
-void collectAll(PokemonNode *root, NodeArray *na);
+int countPokemonNodes(PokemonNode *root);
 
 /**
  * @brief Compare function for qsort (alphabetical by node->data->name).
@@ -285,12 +490,19 @@ void collectAll(PokemonNode *root, NodeArray *na);
 int compareByNameNode(const void *a, const void *b);
 
 /**
- * @brief BFS is nice, but alphabetical means we gather all nodes, sort by name, then print.
+ * @brief Print Pokemon sorted by name, bucketing each node by its precomputed alphabetical rank.
  * @param root BST root
- * Why we made it: Provide user the option to see Pokemon sorted by name.
+ * Why we made it: Names are static, so one counting pass replaces gathering + qsort + strcmp.
  */
 void displayAlphabetical(PokemonNode *root);
 
+/**
+ * @brief Write Pokemon sorted by name to a stream (see displayAlphabetical).
+ * @param out stream to write to
+ * @param root BST root
+ */
+void writeAlphabetical(FILE *out, PokemonNode *root);
+
 /**
  * @brief BFS user-friendly display (level-order).
  * @param root BST root
@@ -337,6 +549,60 @@ void pokemonFight(OwnerNode *owner);
  */
 void evolvePokemon(OwnerNode *owner);
 
+/**
+ * @brief Evolve one Pokemon (ID -> ID+1) without any prompting.
+ * @param owner pointer to the Owner
+ * @param id ID to evolve
+ * @return 1 if evolved, 0 if the owner doesn't have it, -1 if it can't evolve
+ */
+int evolvePokemonByID(OwnerNode *owner, int id);
+
+/**
+ * @brief Precompute the per-species lookup tables derived from pokedex[].
+ * Why we made it: Species data is static, so we derive tables like the evolution chain once at startup.
+ */
+void initSpeciesTables(void);
+
+/**
+ * @brief Final stage of the evolution chain that starts at the given ID.
+ * @param id species ID
+ * @return ID reached by evolving repeatedly (id itself if it cannot evolve)
+ * Why we made it: Evolve-to-final-form needs the last stage without walking the chain each time.
+ */
+int getFinalEvolutionID(int id);
+
+/**
+ * @brief Evolve every eligible node of a BST in one in-order pass.
+ * @param root BST root
+ * @param toFinalForm 0 = evolve one step (ID -> ID+1), 1 = jump to the final stage
+ * @param out where to report each evolution (NULL = silently)
+ * @return updated BST root
+ * Why we made it: Evolution never breaks ID order, so collisions are merged in one sorted pass.
+ */
+PokemonNode *evolveAllNodes(PokemonNode *root, int toFinalForm, FILE *out);
+
+/**
+ * @brief Evolve an owner's whole Pokedex, keeping an undo snapshot.
+ * @param owner pointer to the Owner
+ * @param toFinalForm 0 = one step, 1 = final stage
+ * @param out where to report each evolution (NULL = silently)
+ */
+void evolveOwnerPokedex(OwnerNode *owner, int toFinalForm, FILE *out);
+
+/**
+ * @brief Evolve every Pokemon in the owner's Pokedex by one step.
+ * @param owner pointer to the Owner
+ * Why we made it: Saves a menu round-trip per Pokemon when evolving a whole collection.
+ */
+void evolveAllPokemon(OwnerNode *owner);
+
+/**
+ * @brief Evolve every Pokemon in the owner's Pokedex to its final form.
+ * @param owner pointer to the Owner
+ * Why we made it: Walks each Pokemon straight to the end of its evolution chain.
+ */
+void evolveToFinalForm(OwnerNode *owner);
+
 /**
  * @brief Prompt for an ID, BFS-check duplicates, then insert into BST.
  * @param owner pointer to the Owner
@@ -344,6 +610,48 @@ void evolvePokemon(OwnerNode *owner);
  */
 void addPokemon(OwnerNode *owner);
 
+/**
+ * @brief Add one Pokemon by ID without any prompting.
+ * @param owner pointer to the Owner
+ * @param id ID to add
+ * @return 1 if added, 0 if already there or out of range, -1 if out of memory
+ */
+int addPokemonByID(OwnerNode *owner, int id);
+
+/**
+ * @brief Merge a list of species IDs into a BST in one linear pass.
+ * @param root BST root
+ * @param ids species IDs in any order (duplicates and out-of-range IDs allowed)
+ * @param count number of IDs
+ * @param added out: number of species actually added (may be NULL)
+ * @return root of the resulting balanced BST
+ * Why we made it: Adding dozens of species one insert at a time costs a BFS + insert each.
+ */
+PokemonNode *bulkInsertPokemonIDs(PokemonNode *root, const int *ids, int count, int *added);
+
+/**
+ * @brief Prompt for a list of IDs on one line and add them all at once.
+ * @param owner pointer to the Owner
+ * Why we made it: Onboarding hands out many species at once; one prompt beats dozens.
+ */
+void bulkAddPokemon(OwnerNode *owner);
+
+/**
+ * @brief Add many Pokemon by ID at once, keeping an undo snapshot.
+ * @param owner pointer to the Owner
+ * @param ids species IDs in any order
+ * @param count number of IDs
+ * @return number of species actually added
+ */
+int bulkAddToOwner(OwnerNode *owner, const int *ids, int count);
+
+/**
+ * @brief Prompt for a name or prefix and show the owner's matching Pokemon.
+ * @param owner pointer to the Owner
+ * Why we made it: Prefix search first, fuzzy search as a fallback for typos.
+ */
+void searchPokemonByName(OwnerNode *owner);
+
 /**
  * @brief Prompt for ID, remove that Pokemon from BST by ID.
  * @param owner pointer to the Owner
@@ -351,6 +659,14 @@ void addPokemon(OwnerNode *owner);
  */
 void freePokemon(OwnerNode *owner);
 
+/**
+ * @brief Release one Pokemon by ID without any prompting (lazily if the owner opted in).
+ * @param owner pointer to the Owner
+ * @param id ID to release
+ * @return 1 if released, 0 if the owner doesn't have it
+ */
+int releasePokemonByID(OwnerNode *owner, int id);
+
 /* ------------------------------------------------------------
    7) Display Menu for a Pokedex
    ------------------------------------------------------------ */
@@ -363,49 +679,67 @@ void freePokemon(OwnerNode *owner);
 void displayMenu(OwnerNode *owner);
 
 /* ------------------------------------------------------------
-   8) Sorting Owners (Bubble Sort on Circular List)
+   8) Sorting Owners (Per-Shard Sort + K-Way Merge)
    ------------------------------------------------------------ */
 
 /**
- * @brief Sort the circular owners list by name.
- * Why we made it: Another demonstration of pointer manipulation + sorting logic.
+ * @brief Renumber the owner listing in name order.
+ * Why we made it: Each shard sorts its own ring, then one merge pass across shards
+ * hands out the new listing ranks; no owner data moves between nodes.
  */
 void sortOwners(void);
 
-/**
- * @brief Helper to swap name & pokedexRoot in two OwnerNode.
- * @param a pointer to first owner
- * @param b pointer to second owner
- * Why we made it: Used internally by bubble sort to swap data.
- */
-void swapOwnerData(OwnerNode *a, OwnerNode *b);
-
 /* ------------------------------------------------------------
    9) Circular List Linking & Searching
    ------------------------------------------------------------ */
 
 /**
- * @brief Insert a new owner into the circular list. If none exist, it's alone.
+ * @brief Add a new owner to its shard's ring and name index, last in the listing.
  * @param newOwner pointer to newly created OwnerNode
  * Why we made it: We need a standard approach to keep the list circular.
  */
 void linkOwnerInCircularList(OwnerNode *newOwner);
 
 /**
- * @brief Remove a specific OwnerNode from the circular list, possibly updating head.
+ * @brief Add many new owners at once, last in the listing, in array order.
+ * @param owners newly created owners
+ * @param count number of owners
+ * Why we made it: Each shard's index is sized once for the whole batch instead of
+ * being rehashed every time it doubles.
+ */
+void linkOwnersBatch(OwnerNode **owners, size_t count);
+
+/**
+ * @brief Remove a specific OwnerNode from its shard's ring and name index.
  * @param target pointer to the OwnerNode
  * Why we made it: Deleting or merging owners requires removing them from the ring.
  */
 void removeOwnerFromCircularList(OwnerNode *target);
 
 /**
- * @brief Find an owner by name in the circular list.
+ * @brief Find an owner by name through its shard's index.
  * @param name string to match
  * @return pointer to the matching OwnerNode or NULL
  * Why we made it: We often need to locate an owner quickly.
  */
 OwnerNode *findOwnerByName(const char *name);
 
+/**
+ * @brief Lock two different owners in address order.
+ * @param a first owner
+ * @param b second owner
+ * Why we made it: Two merges naming the same pair in opposite order must not deadlock.
+ */
+void lockOwnerPair(OwnerNode *a, OwnerNode *b);
+
+/**
+ * @brief Lock a set of different owners in address order.
+ * @param owners owners to lock (reordered by address; unlock in any order)
+ * @param count number of owners
+ * Why we made it: Same deadlock rule as lockOwnerPair, for merges naming many owners.
+ */
+void lockOwnerSet(OwnerNode **owners, int count);
+
 /* ------------------------------------------------------------
    10) Owner Menus
    ------------------------------------------------------------ */
@@ -428,6 +762,26 @@ void openPokedexMenu(void);
  */
 void deletePokedex(void);
 
+/**
+ * @brief Free every Pokemon an owner has; the owner itself stays.
+ * @param owner pointer to the Owner
+ */
+void clearOwnerPokedex(OwnerNode *owner);
+
+/**
+ * @brief Copy ownerOut's Pokedex into ownerIn's (keeping an undo snapshot); ownerOut is untouched.
+ * @param ownerIn owner that receives the Pokemon
+ * @param ownerOut owner whose Pokemon are copied
+ */
+void mergePokedexInto(OwnerNode *ownerIn, OwnerNode *ownerOut);
+
+/**
+ * @brief Merge ownerOut's Pokedex into ownerIn's, then unlink and free ownerOut.
+ * @param ownerIn owner that keeps the merged Pokedex
+ * @param ownerOut owner that is removed
+ */
+void mergeOwners(OwnerNode *ownerIn, OwnerNode *ownerOut);
+
 /**
  * @brief Merge the second owner's Pokedex into the first, then remove the second owner.
  * Why we made it: BFS copy demonstration plus removing an owner.
@@ -449,7 +803,7 @@ void printOwnersCircular(void);
    ------------------------------------------------------------ */
 
 /**
- * @brief Frees every remaining owner in the circular list, setting ownerHead = NULL.
+ * @brief Frees every remaining owner and empties every shard.
  * Why we made it: Ensures a squeaky-clean exit with no leftover memory.
  */
 void freeAllOwners(void);
@@ -464,110 +818,1061 @@ void freeAllOwners(void);
  */
 void mainMenu(void);
 
-// Array of Pokemon data
-static const PokemonData pokedex[] = {
-    {1, "Bulbasaur", GRASS, 45, 49, CAN_EVOLVE},
-    {2, "Ivysaur", GRASS, 60, 62, CAN_EVOLVE},
-    {3, "Venusaur", GRASS, 80, 82, CANNOT_EVOLVE},
-    {4, "Charmander", FIRE, 39, 52, CAN_EVOLVE},
-    {5, "Charmeleon", FIRE, 58, 64, CAN_EVOLVE},
-    {6, "Charizard", FIRE, 78, 84, CANNOT_EVOLVE},
-    {7, "Squirtle", WATER, 44, 48, CAN_EVOLVE},
-    {8, "Wartortle", WATER, 59, 63, CAN_EVOLVE},
-    {9, "Blastoise", WATER, 79, 83, CANNOT_EVOLVE},
-    {10, "Caterpie", BUG, 45, 30, CAN_EVOLVE},
-    {11, "Metapod", BUG, 50, 20, CAN_EVOLVE},
-    {12, "Butterfree", BUG, 60, 45, CANNOT_EVOLVE},
-    {13, "Weedle", BUG, 40, 35, CAN_EVOLVE},
-    {14, "Kakuna", BUG, 45, 25, CAN_EVOLVE},
-    {15, "Beedrill", BUG, 65, 90, CANNOT_EVOLVE},
-    {16, "Pidgey", NORMAL, 40, 45, CAN_EVOLVE},
-    {17, "Pidgeotto", NORMAL, 63, 60, CAN_EVOLVE},
-    {18, "Pidgeot", NORMAL, 83, 80, CANNOT_EVOLVE},
-    {19, "Rattata", NORMAL, 30, 56, CAN_EVOLVE},
-    {20, "Raticate", NORMAL, 55, 81, CANNOT_EVOLVE},
-    {21, "Spearow", NORMAL, 40, 60, CAN_EVOLVE},
-    {22, "Fearow", NORMAL, 65, 90, CANNOT_EVOLVE},
-    {23, "Ekans", POISON, 35, 60, CAN_EVOLVE},
-    {24, "Arbok", POISON, 60, 85, CANNOT_EVOLVE},
-    {25, "Pikachu", ELECTRIC, 35, 55, CAN_EVOLVE},
-    {26, "Raichu", ELECTRIC, 60, 90, CANNOT_EVOLVE},
-    {27, "Sandshrew", GROUND, 50, 75, CAN_EVOLVE},
-    {28, "Sandslash", GROUND, 75, 100, CANNOT_EVOLVE},
-    {29, "NidoranF", POISON, 55, 47, CAN_EVOLVE},
-    {30, "Nidorina", POISON, 70, 62, CAN_EVOLVE},
-    {31, "Nidoqueen", POISON, 90, 92, CANNOT_EVOLVE},
-    {32, "NidoranM", POISON, 46, 57, CAN_EVOLVE},
-    {33, "Nidorino", POISON, 61, 72, CAN_EVOLVE},
-    {34, "Nidoking", POISON, 81, 102, CANNOT_EVOLVE},
-    {35, "Clefairy", FAIRY, 70, 45, CAN_EVOLVE},
-    {36, "Clefable", FAIRY, 95, 70, CANNOT_EVOLVE},
-    {37, "Vulpix", FIRE, 38, 41, CAN_EVOLVE},
-    {38, "Ninetales", FIRE, 73, 76, CANNOT_EVOLVE},
-    {39, "Jigglypuff", NORMAL, 115, 45, CAN_EVOLVE},
-    {40, "Wigglytuff", NORMAL, 140, 70, CANNOT_EVOLVE},
-    {41, "Zubat", POISON, 40, 45, CAN_EVOLVE},
-    {42, "Golbat", POISON, 75, 80, CAN_EVOLVE},
-    {43, "Oddish", GRASS, 45, 50, CAN_EVOLVE},
-    {44, "Gloom", GRASS, 60, 65, CAN_EVOLVE},
-    {45, "Vileplume", GRASS, 75, 80, CANNOT_EVOLVE},
-    {46, "Paras", BUG, 35, 70, CAN_EVOLVE},
-    {47, "Parasect", BUG, 60, 95, CANNOT_EVOLVE},
-    {48, "Venonat", BUG, 60, 55, CAN_EVOLVE},
-    {49, "Venomoth", BUG, 70, 65, CANNOT_EVOLVE},
-    {50, "Diglett", GROUND, 10, 55, CAN_EVOLVE},
-    {51, "Dugtrio", GROUND, 35, 80, CANNOT_EVOLVE},
-    {52, "Meowth", NORMAL, 40, 45, CAN_EVOLVE},
-    {53, "Persian", NORMAL, 65, 70, CANNOT_EVOLVE},
-    {54, "Psyduck", WATER, 50, 52, CAN_EVOLVE},
-    {55, "Golduck", WATER, 80, 82, CANNOT_EVOLVE},
-    {56, "Mankey", FIGHTING, 40, 80, CAN_EVOLVE},
-    {57, "Primeape", FIGHTING, 65, 105, CANNOT_EVOLVE},
-    {58, "Growlithe", FIRE, 55, 70, CAN_EVOLVE},
-    {59, "Arcanine", FIRE, 90, 110, CANNOT_EVOLVE},
-    {60, "Poliwag", WATER, 40, 50, CAN_EVOLVE},
-    {61, "Poliwhirl", WATER, 65, 65, CAN_EVOLVE},
-    {62, "Poliwrath", WATER, 90, 95, CANNOT_EVOLVE},
-    {63, "Abra", PSYCHIC, 25, 20, CAN_EVOLVE},
-    {64, "Kadabra", PSYCHIC, 40, 35, CAN_EVOLVE},
-    {65, "Alakazam", PSYCHIC, 55, 50, CANNOT_EVOLVE},
-    {66, "Machop", FIGHTING, 70, 80, CAN_EVOLVE},
-    {67, "Machoke", FIGHTING, 80, 100, CAN_EVOLVE},
-    {68, "Machamp", FIGHTING, 90, 130, CANNOT_EVOLVE},
-    {69, "Bellsprout", GRASS, 50, 75, CAN_EVOLVE},
-    {70, "Weepinbell", GRASS, 65, 90, CAN_EVOLVE},
-    {71, "Victreebel", GRASS, 80, 105, CANNOT_EVOLVE},
-    {72, "Tentacool", WATER, 40, 40, CAN_EVOLVE},
-    {73, "Tentacruel", WATER, 80, 70, CANNOT_EVOLVE},
-    {74, "Geodude", ROCK, 40, 80, CAN_EVOLVE},
-    {75, "Graveler", ROCK, 55, 95, CAN_EVOLVE},
-    {76, "Golem", ROCK, 80, 120, CANNOT_EVOLVE},
-    {77, "Ponyta", FIRE, 50, 85, CAN_EVOLVE},
-    {78, "Rapidash", FIRE, 65, 100, CANNOT_EVOLVE},
-    {79, "Slowpoke", WATER, 90, 65, CAN_EVOLVE},
-    {80, "Slowbro", WATER, 95, 75, CANNOT_EVOLVE},
-    {81, "Magnemite", ELECTRIC, 25, 35, CAN_EVOLVE},
-    {82, "Magneton", ELECTRIC, 50, 60, CANNOT_EVOLVE},
-    {83, "Farfetch'd", NORMAL, 52, 65, CANNOT_EVOLVE},
-    {84, "Doduo", NORMAL, 35, 85, CAN_EVOLVE},
-    {85, "Dodrio", NORMAL, 60, 110, CANNOT_EVOLVE},
-    {86, "Seel", WATER, 65, 45, CAN_EVOLVE},
-    {87, "Dewgong", WATER, 90, 70, CANNOT_EVOLVE},
-    {88, "Grimer", POISON, 80, 80, CAN_EVOLVE},
-    {89, "Muk", POISON, 105, 105, CANNOT_EVOLVE},
-    {90, "Shellder", WATER, 30, 65, CAN_EVOLVE},
-    {91, "Cloyster", WATER, 50, 95, CANNOT_EVOLVE},
-    {92, "Gastly", GHOST, 30, 35, CAN_EVOLVE},
-    {93, "Haunter", GHOST, 45, 50, CAN_EVOLVE},
-    {94, "Gengar", GHOST, 60, 65, CANNOT_EVOLVE},
-    {95, "Onix", ROCK, 35, 45, CANNOT_EVOLVE},
-    {96, "Drowzee", PSYCHIC, 60, 48, CAN_EVOLVE},
-    {97, "Hypno", PSYCHIC, 85, 73, CANNOT_EVOLVE},
-    {98, "Krabby", WATER, 30, 105, CAN_EVOLVE},
-    {99, "Kingler", WATER, 55, 130, CANNOT_EVOLVE},
-    {100, "Voltorb", ELECTRIC, 40, 30, CAN_EVOLVE},
-    {101, "Electrode", ELECTRIC, 60, 50, CANNOT_EVOLVE},
-    {102, "Exeggcute", GRASS, 60, 40, CAN_EVOLVE},
+/* ------------------------------------------------------------
+   14) Compact Pokedex (Array-Indexed Tree)
+   ------------------------------------------------------------ */
+
+// Which order a traversal visits the nodes in
+typedef enum
+{
+    ORDER_BFS,
+    ORDER_PRE,
+    ORDER_IN,
+    ORDER_POST
+} TraversalOrder;
+
+#define COMPACT_NIL UINT32_MAX
+
+/*
+ * The same BST as a PokemonNode tree, stored in one contiguous block as parallel
+ * arrays: 32-bit child indices and a 16-bit species index per slot (10 bytes per node
+ * instead of 24). Freed slots are chained through right[] starting at freeHead.
+ * With --engine compact this is each owner's working Pokedex (section 17): adds,
+ * releases, lookups and the four tree displays run on it, and clones copy it with one
+ * memcpy. The PokemonNode tree stays the canonical copy for bulk changes, name search,
+ * saving and the server's published views.
+ */
+typedef struct CompactPokedex
+{
+    uint32_t *left;     // left child index per slot, COMPACT_NIL if none
+    uint32_t *right;    // right child index, or next free slot for freed slots
+    uint16_t *species;  // ID of the species in the slot, 0 if the slot is free
+    uint32_t capacity;  // slots allocated
+    uint32_t used;      // slots ever handed out (high-water mark)
+    uint32_t count;     // live nodes
+    uint32_t root;      // root slot, COMPACT_NIL if empty
+    uint32_t freeHead;  // first freed slot, COMPACT_NIL if none
+} CompactPokedex;
+
+/**
+ * @brief Create an empty compact Pokedex.
+ * @param capacity initial number of slots (grows on demand)
+ * @return newly allocated CompactPokedex*, or NULL on failure
+ * Why we made it: An owner's tree in a few cache lines instead of scattered heap nodes.
+ */
+CompactPokedex *createCompactPokedex(uint32_t capacity);
+
+/**
+ * @brief Free a compact Pokedex and its slot block.
+ * @param dex pointer to the compact Pokedex (may be NULL)
+ */
+void freeCompactPokedex(CompactPokedex *dex);
+
+/**
+ * @brief Insert a species by ID; duplicates ignored (like insertPokemonNode).
+ * @param dex pointer to the compact Pokedex
+ * @param data species to insert (from the global pokedex)
+ * @return 1 if inserted, 0 if already present, -1 if out of memory
+ */
+int compactInsert(CompactPokedex *dex, const PokemonData *data);
+
+/**
+ * @brief Remove a species by ID (like removeNodeBST); its slot goes on the free list.
+ * @param dex pointer to the compact Pokedex
+ * @param id ID to remove
+ * @return 1 if removed, 0 if not found
+ */
+int compactRemove(CompactPokedex *dex, int id);
+
+/**
+ * @brief Find a species by ID by descending the tree.
+ * @param dex pointer to the compact Pokedex
+ * @param id ID to find
+ * @return species data, or NULL if not present
+ */
+const PokemonData *compactSearch(const CompactPokedex *dex, int id);
+
+/**
+ * @brief Walk the compact tree in the given order, calling visit() like the *Generic walkers.
+ * @param dex pointer to the compact Pokedex
+ * @param order BFS, pre-, in- or post-order
+ * @param visit receives a PokemonNode view of each slot (children are not filled in)
+ * Why we made it: Lets printPokemonNode and the other VisitNodeFuncs work unchanged.
+ */
+void compactTraverse(const CompactPokedex *dex, TraversalOrder order, VisitNodeFunc visit);
+
+/**
+ * @brief Build a compact Pokedex with the same shape as a PokemonNode tree.
+ * @param root BST root
+ * @return newly allocated CompactPokedex*, or NULL on failure
+ */
+CompactPokedex *compactFromTree(PokemonNode *root);
+
+/**
+ * @brief Copy a compact Pokedex with a single memcpy of its slot block.
+ * @param dex pointer to the compact Pokedex
+ * @return independent copy, or NULL on failure
+ * Why we made it: Index-based links stay valid in a copy, so cloning an owner's compact
+ * Pokedex needs no pointer fix-up.
+ */
+CompactPokedex *compactSnapshot(const CompactPokedex *dex);
+
+/* ------------------------------------------------------------
+   15) Frozen Pokedex (Eytzinger Layout for Read-Heavy Owners)
+   ------------------------------------------------------------ */
+
+/*
+ * A sorted copy of an owner's IDs laid out in BFS (Eytzinger) order: the children of
+ * keys[k] are keys[2k] and keys[2k+1], with keys[0] unused. Searching it is a branchless
+ * descent over one small array instead of chasing node pointers.
+ */
+typedef struct FrozenPokedex
+{
+    uint16_t *keys; // keys[1..size] in Eytzinger order
+    uint32_t size;  // number of IDs
+} FrozenPokedex;
+
+/**
+ * @brief Build the Eytzinger copy of an owner's Pokedex (replacing an old one).
+ * @param owner pointer to the Owner
+ * Why we made it: Owners that only fight/display/look up get cache-friendly searches.
+ */
+void freezePokedex(OwnerNode *owner);
+
+/**
+ * @brief Drop the owner's frozen and engine copies; every bulk change goes through this first.
+ * @param owner pointer to the Owner
+ * Why we made it: The copies don't follow the tree, so changes must invalidate them.
+ */
+void thawPokedex(OwnerNode *owner);
+
+/**
+ * @brief Drop only the owner's frozen copy; single-Pokemon changes go through this first.
+ * @param owner pointer to the Owner
+ * Why we made it: Adds, releases and evolves update the engine copy in place instead.
+ */
+void thawFrozenPokedex(OwnerNode *owner);
+
+/**
+ * @brief Branchless search of a frozen Pokedex.
+ * @param frozen pointer to the frozen Pokedex
+ * @param id ID to find
+ * @return species data, or NULL if not present
+ */
+const PokemonData *frozenSearch(const FrozenPokedex *frozen, int id);
+
+/**
+ * @brief Look up a species in an owner's Pokedex, using the frozen copy when there is one.
+ * @param owner pointer to the Owner
+ * @param id ID to find
+ * @return species data, or NULL if the owner doesn't have it
+ */
+const PokemonData *ownerFindPokemon(OwnerNode *owner, int id);
+
+/**
+ * @brief Menu entry: freeze the owner's Pokedex for fast lookups.
+ * @param owner pointer to the Owner
+ */
+void freezePokedexMenu(OwnerNode *owner);
+
+/* ------------------------------------------------------------
+   16) B-Tree Pokedex
+   ------------------------------------------------------------ */
+
+// Minimum degree t: nodes hold t-1..2t-1 keys (the root may hold fewer)
+#define BTREE_MIN_DEGREE 8
+#define BTREE_MAX_KEYS (2 * BTREE_MIN_DEGREE - 1)
+
+/*
+ * Keys are species IDs, which all fit in a byte (POKEDEX_SIZE < 256). The key count,
+ * leaf flag and all 15 keys share the first 64-byte line of a node, so a search scans
+ * one line per level and then follows a single child pointer.
+ */
+typedef struct BTreeNode
+{
+    uint8_t count;                                 // keys in use
+    uint8_t leaf;                                  // 1 if the node has no children
+    uint8_t keys[BTREE_MAX_KEYS];                  // ascending species IDs
+    struct BTreeNode *children[BTREE_MAX_KEYS + 1]; // count + 1 children unless leaf
+} BTreeNode;
+
+typedef struct
+{
+    BTreeNode *root;
+    uint32_t count; // keys stored
+} BTreePokedex;
+
+/**
+ * @brief Create an empty B-tree Pokedex.
+ * @return newly allocated BTreePokedex*, or NULL on failure
+ * Why we made it: Large collections spend fewer cache lines per level than a binary tree.
+ */
+BTreePokedex *createBTreePokedex(void);
+
+/**
+ * @brief Free a B-tree Pokedex and all of its nodes.
+ * @param dex pointer to the B-tree Pokedex (may be NULL)
+ */
+void freeBTreePokedex(BTreePokedex *dex);
+
+/**
+ * @brief Insert a species by ID; duplicates ignored (like insertPokemonNode).
+ * @param dex pointer to the B-tree Pokedex
+ * @param data species to insert (from the global pokedex)
+ * @return 1 if inserted, 0 if already present, -1 if out of memory
+ */
+int btreeInsert(BTreePokedex *dex, const PokemonData *data);
+
+/**
+ * @brief Remove a species by ID (like removeNodeBST).
+ * @param dex pointer to the B-tree Pokedex
+ * @param id ID to remove
+ * @return 1 if removed, 0 if not found
+ */
+int btreeRemove(BTreePokedex *dex, int id);
+
+/**
+ * @brief Find a species by ID.
+ * @param dex pointer to the B-tree Pokedex
+ * @param id ID to find
+ * @return species data, or NULL if not present
+ */
+const PokemonData *btreeSearch(const BTreePokedex *dex, int id);
+
+/**
+ * @brief Walk the B-tree in the given order, calling visit() like the *Generic walkers.
+ * @param dex pointer to the B-tree Pokedex
+ * @param order BFS (node by node, level order), pre-, in- or post-order
+ * @param visit receives a PokemonNode view of each key
+ */
+void btreeTraverse(const BTreePokedex *dex, TraversalOrder order, VisitNodeFunc visit);
+
+/* ------------------------------------------------------------
+   17) Selectable Pokedex Engines
+   ------------------------------------------------------------ */
+
+/*
+ * One Pokedex backend behind a common interface: the same operations as
+ * insertPokemonNode / removeNodeBST / search / the four traversals, on an opaque handle.
+ */
+typedef struct
+{
+    const char *name;
+    void *(*create)(void);
+    void (*destroy)(void *dex);
+    int (*insert)(void *dex, const PokemonData *data); // 1 inserted, 0 duplicate, -1 no memory
+    int (*remove)(void *dex, int id);                  // 1 removed, 0 not found
+    const PokemonData *(*search)(void *dex, int id);
+    void (*traverse)(void *dex, TraversalOrder order, VisitNodeFunc visit);
+    void *(*copy)(void *dex); // independent copy, NULL if out of memory; may itself be NULL
+} PokedexEngine;
+
+/**
+ * @brief Look up a Pokedex engine by name.
+ * @param name engine name ("bst", "compact", "btree", ...)
+ * @return the engine, or NULL if there is none by that name
+ * Why we made it: Callers and benchmarks pick a backend by name behind one interface.
+ */
+const PokedexEngine *findPokedexEngine(const char *name);
+
+/*
+ * With --engine NAME, each owner also keeps its Pokedex in that backend. Lookups
+ * (fight, evolve, add's duplicate check, server FIGHT) and the four tree displays run on
+ * it, and adds, releases and evolves are applied to it as they happen. The PokemonNode
+ * tree stays the canonical copy: bulk changes (bulk add, evolve-all, merges), name
+ * search, saving and the server's published views work on the tree, and a bulk change
+ * drops the engine copy until the next lookup rebuilds it. An undo snapshot keeps the
+ * engine copy from before the bulk change, so undo puts it back without a rebuild, and a
+ * clone copies it when the backend has a copy operation (compact does, with one memcpy).
+ */
+
+// Backend the owners' Pokedexes are mirrored into (--engine NAME); NULL = trees only
+const PokedexEngine *lookupEngine = NULL;
+
+/**
+ * @brief Get the owner's Pokedex in lookupEngine's backend, building it on first use.
+ * @param owner pointer to the Owner
+ * @return engine handle, or NULL if there's no lookupEngine or memory ran out
+ * Why we made it: Lookups, displays and single-Pokemon changes run on the selected
+ * backend, built once per owner rather than per query.
+ */
+void *ownerEngineCopy(OwnerNode *owner);
+
+/**
+ * @brief Apply an add to the owner's engine copy, if it has one.
+ * @param owner pointer to the Owner
+ * @param data species added to the tree
+ */
+void engineCopyInsert(OwnerNode *owner, const PokemonData *data);
+
+/**
+ * @brief Apply a release to the owner's engine copy, if it has one.
+ * @param owner pointer to the Owner
+ * @param id ID released from the tree
+ */
+void engineCopyRemove(OwnerNode *owner, int id);
+
+/**
+ * @brief Drop the owner's engine copy (thawPokedex does this on every bulk change).
+ * @param owner pointer to the Owner
+ */
+void dropEngineCopy(OwnerNode *owner);
+
+/**
+ * @brief Drop the engine copy kept with the owner's undo snapshot.
+ * @param owner pointer to the Owner
+ */
+void dropEngineSnapshot(OwnerNode *owner);
+
+/**
+ * @brief Copy an engine handle with lookupEngine's copy operation.
+ * @param dex engine handle (may be NULL)
+ * @return independent copy, or NULL if there's nothing to copy, no copy operation or no memory
+ * Why we made it: A clone starts with its source's engine copy instead of rebuilding it.
+ */
+void *copyEngineDex(void *dex);
+
+/* ------------------------------------------------------------
+   18) Treap Pokedex (Self-Adjusting by Access Counts)
+   ------------------------------------------------------------ */
+
+// A BST of ordinary PokemonNodes, heap-ordered by lookup count: no node has more hits
+// than its parent, so the most looked-up IDs sit at the top
+typedef struct
+{
+    PokemonNode *root;
+    uint32_t count;  // nodes stored
+    uint32_t hits[]; // lookups per species ID (index 0 unused), sized at creation
+} TreapPokedex;
+
+/**
+ * @brief Create an empty access-count treap Pokedex.
+ * @return newly allocated TreapPokedex*, or NULL on failure
+ * Why we made it: Popular species (starters, Pikachu) rise to the root and stay there.
+ */
+TreapPokedex *createTreapPokedex(void);
+
+/**
+ * @brief Free a treap Pokedex and all of its nodes.
+ * @param dex pointer to the treap Pokedex (may be NULL)
+ */
+void freeTreapPokedex(TreapPokedex *dex);
+
+/**
+ * @brief Insert a species by ID as a leaf with no hits yet; duplicates ignored.
+ * @param dex pointer to the treap Pokedex
+ * @param data species to insert (from the global pokedex)
+ * @return 1 if inserted, 0 if already present, -1 if out of memory
+ */
+int treapInsert(TreapPokedex *dex, const PokemonData *data);
+
+/**
+ * @brief Remove a species by ID (like removeNodeBST), rotating it down to a leaf first.
+ * @param dex pointer to the treap Pokedex
+ * @param id ID to remove
+ * @return 1 if removed, 0 if not found
+ */
+int treapRemove(TreapPokedex *dex, int id);
+
+/**
+ * @brief Find a species by ID, count the hit and rotate it above any parent it overtook.
+ * @param dex pointer to the treap Pokedex
+ * @param id ID to find
+ * @return species data, or NULL if not present
+ */
+const PokemonData *treapSearch(TreapPokedex *dex, int id);
+
+/**
+ * @brief Walk the treap in the given order (counts no hits).
+ * @param dex pointer to the treap Pokedex
+ * @param order BFS, pre-, in- or post-order
+ * @param visit function pointer
+ */
+void treapTraverse(TreapPokedex *dex, TraversalOrder order, VisitNodeFunc visit);
+
+/* ------------------------------------------------------------
+   19) Shared Pokedexes: Undo Snapshots, Clones, Joins
+   ------------------------------------------------------------ */
+
+/*
+ * Pokedex trees share structure. Every parent link and every root (an owner's
+ * pokedexRoot, its snapshot) holds one reference to the node it points at, counted in
+ * refs. Single-Pokemon changes copy only the shared nodes on their search path (path
+ * copying), and bulk changes unshare the whole tree first, so a snapshot or a clone
+ * never sees a later change. refs is only touched under the owner locks of every tree
+ * using the node: snapshots stay with their owner, clones are made from the
+ * single-threaded menus, and a merged-away owner is locked until it is reaped.
+ */
+
+/**
+ * @brief Remember the owner's Pokedex before a bulk change (replacing the old snapshot).
+ * @param owner pointer to the Owner
+ * Why we made it: Bulk add, evolve-all and merge can't be undone one Pokemon at a time.
+ * The snapshot shares the live tree's nodes, so taking it is O(1).
+ */
+void snapshotPokedex(OwnerNode *owner);
+
+/**
+ * @brief Menu entry: put back the Pokedex saved before the last bulk change.
+ * @param owner pointer to the Owner
+ */
+void restorePokedexSnapshot(OwnerNode *owner);
+
+/**
+ * @brief Join another tree onto a BST when their ID ranges don't overlap (O(height)).
+ * @param root pointer to the BST root (updated; still valid if the join fails)
+ * @param other tree to join (shared, not consumed)
+ * @return 1 if joined, 0 if the ranges overlap, -1 if out of memory
+ * Why we made it: Merging a disjoint Pokedex hangs it off the new root instead of
+ * copying it node by node; only the path to the lower tree's maximum is copied.
+ */
+int joinPokemonTrees(PokemonNode **root, PokemonNode *other);
+
+/**
+ * @brief Share an owner's Pokedex with a new owner, undo snapshot included (O(1)).
+ * Why we made it: Lets a player branch off an existing collection and try things out.
+ */
+void cloneOwnerMenu(void);
+
+/* ------------------------------------------------------------
+   20) Lazy Release (Tombstones)
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Release a Pokemon by leaving a tombstone, compacting once enough pile up.
+ * @param owner pointer to the Owner
+ * @param id ID to release
+ * @return 1 if released, 0 if the owner doesn't have it
+ */
+int releasePokemonLazy(OwnerNode *owner, int id);
+
+/**
+ * @brief Drop the owner's tombstones now (no-op when there are none).
+ * @param owner pointer to the Owner
+ * Why we made it: Bulk operations relink nodes and must only ever see live ones.
+ */
+void compactPokedex(OwnerNode *owner);
+
+/**
+ * @brief Re-count the owner's tombstones and schedule the next check.
+ * @param owner pointer to the Owner
+ * Why we made it: A restored snapshot may hold tombstones the counter doesn't know about.
+ */
+void recountTombstones(OwnerNode *owner);
+
+/**
+ * @brief Menu entry: switch lazy release on or off (off compacts right away).
+ * @param owner pointer to the Owner
+ */
+void toggleLazyRelease(OwnerNode *owner);
+
+/* ------------------------------------------------------------
+   21) Process Arena
+   ------------------------------------------------------------ */
+
+/*
+ * Owners, owner names, Pokedex nodes and frozen copies all come from
+ * one process-wide arena. Freed objects go on per-size-class free lists for reuse, and
+ * exit hands everything back in one arenaReset(). Build with -DARENA_DEBUG (make
+ * ARENA_DEBUG=1) to route every call to malloc/free so valgrind still sees each object.
+ */
+
+/**
+ * @brief Allocate size bytes from the process arena.
+ * @param size bytes wanted
+ * @return pointer to uninitialized memory, or NULL if out of memory
+ */
+void *arenaAlloc(size_t size);
+
+/**
+ * @brief Give memory back to the arena's free list for its size class.
+ * @param ptr pointer from arenaAlloc (may be NULL)
+ * @param size the size passed to arenaAlloc
+ */
+void arenaFree(void *ptr, size_t size);
+
+/**
+ * @brief Copy a string into the arena.
+ * @param str string to copy
+ * @return arena copy (free with arenaFree(copy, strlen(copy) + 1)), or NULL
+ */
+char *arenaStrdup(const char *str);
+
+/**
+ * @brief Release every arena allocation at once; all arena pointers become invalid.
+ * Why we made it: Tearing down millions of nodes one free() at a time made exit slow.
+ */
+void arenaReset(void);
+
+/* ------------------------------------------------------------
+   22) Server Mode (Unix Domain Socket)
+   ------------------------------------------------------------ */
+
+/*
+ * `ex6 --server PATH` keeps the owner registry resident and serves one-line text commands
+ * (see HELP) from many clients: an epoll loop reads requests and a worker pool runs
+ * them, one request in flight per client. Each reply is "OK" or "ERR <reason>",
+ * then any listing, then a line holding a single ".". `ex6 --client PATH` sends its
+ * stdin line by line and prints the replies; `ex6 --stress PATH [CLIENTS [REQUESTS]]`
+ * runs many random clients at once. Writers lock ownerRingLock, then owner->lock;
+ * readers take no locks (section 23).
+ */
+
+typedef enum
+{
+    COMMAND_OK,
+    COMMAND_QUIT,    // close this client
+    COMMAND_SHUTDOWN // stop the server
+} CommandResult;
+
+/**
+ * @brief Run one text command against the owner registry, writing the reply to out.
+ * @param line command line (modified: it is split into tokens)
+ * @param out stream receiving "OK"/"ERR ..." and any listing
+ * @return COMMAND_QUIT / COMMAND_SHUTDOWN for those commands, else COMMAND_OK
+ * Why we made it: Server clients speak the main menu and Pokedex menu as one-line commands.
+ */
+CommandResult executeCommand(char *line, FILE *out);
+
+/**
+ * @brief Serve the owner registry to many clients over a Unix domain socket.
+ * @param path filesystem path of the socket (replaced if it exists)
+ * @return process exit status
+ * Why we made it: One resident process replaces a process per user plus offline merging.
+ */
+int runServer(const char *path);
+
+/**
+ * @brief Send each stdin line to the server as a command and print the replies.
+ * @param path filesystem path of the server's socket
+ * @return process exit status
+ */
+int runClient(const char *path);
+
+/**
+ * @brief Hammer a running server with concurrent clients and report throughput.
+ * @param path filesystem path of the server's socket
+ * @param clients number of concurrent connections
+ * @param requests requests per connection
+ * @return process exit status (non-zero if any connection broke)
+ * Why we made it: Run against a ThreadSanitizer build of the server to check the locking.
+ */
+int runStress(const char *path, int clients, int requests);
+
+/* ------------------------------------------------------------
+   23) Published Views (Read-Copy-Update)
+   ------------------------------------------------------------ */
+
+/*
+ * Server reads (LIST, SHOW, FIND, FIGHT) take no locks. Each owner has a ViewSlot holding
+ * the current PokedexView of its Pokedex. A writer that changed one Pokedex copies it
+ * into a fresh view and swaps the slot's pointer. Only NEW, SORT and MERGE change which
+ * owners there are, and only they build a new OwnerRingView of the slots and swap the
+ * global pointer. Readers keep using whatever version they loaded. Replaced versions
+ * wait in limbo until every reader has left the epoch in which they were retired.
+ */
+
+typedef struct PokedexView
+{
+    PokemonNode *root;        // Shape-preserving copy, never modified once published
+    struct PokedexView *next; // Limbo list link
+    unsigned long retiredAt;  // Epoch in which it was replaced
+} PokedexView;
+
+typedef struct ViewSlot
+{
+    PokedexView *view;        // Current version (atomic access)
+    char *ownerName;          // Own copy: the owner may be freed while readers look
+    uint32_t nameHash;        // ownerNameHash(ownerName), the ring's lookup key
+    struct ViewSlot *next;    // Limbo list link
+    unsigned long retiredAt;  // Epoch in which it left the published ring
+} ViewSlot;
+
+typedef struct OwnerRingView
+{
+    struct OwnerRingView *next; // Limbo list link
+    unsigned long retiredAt;
+    int count;
+    uint32_t mask;              // index has mask + 1 entries
+    int *index;                 // owners[] positions open-addressed by nameHash, -1 = free
+    ViewSlot *owners[];         // Ring order, merged owners left out
+} OwnerRingView;
+
+/**
+ * @brief Publish a fresh copy of one owner's Pokedex in its slot.
+ * @param owner owner that changed
+ * @return 1 on success, 0 if out of memory (readers keep the previous version)
+ * Why we made it: Caller holds ownerRingLock (either mode) and owner->lock, so the copy is
+ * consistent. Only the owner's slot changes; the ring is rebuilt only for a new owner.
+ */
+int publishOwnerView(OwnerNode *owner);
+
+/**
+ * @brief Publish a new ring version after owners were added, sorted or merged away.
+ * @return 1 on success, 0 if out of memory (readers keep the previous version)
+ * Why we made it: Caller holds ownerRingLock (either mode); merged owners' slots leave
+ * the ring here and are retired with it.
+ */
+int publishOwnerRing(void);
+
+/**
+ * @brief Enter a read-side critical section and load the published ring.
+ * @return current ring version (NULL before the first publish); valid until donePublishedRing
+ */
+const OwnerRingView *readPublishedRing(void);
+
+/**
+ * @brief Leave the read-side critical section opened by readPublishedRing.
+ */
+void donePublishedRing(void);
+
+/**
+ * @brief Find an owner's published Pokedex by name through the ring's hash index.
+ * @param ring ring version from readPublishedRing (may be NULL)
+ * @param name owner name
+ * @return that owner's view or NULL
+ */
+const PokedexView *findPublishedView(const OwnerRingView *ring, const char *name);
+
+/**
+ * @brief Get the current view of the i-th owner in a ring version.
+ * @param ring ring version from readPublishedRing
+ * @param i position in ring order (0 .. count - 1)
+ * @return that owner's view, valid until donePublishedRing
+ */
+const PokedexView *ringViewAt(const OwnerRingView *ring, int i);
+
+/**
+ * @brief Free every published, stale and retired version (no readers may be left).
+ */
+void releasePublishedViews(void);
+
+/* ------------------------------------------------------------
+   24) Sharded Owner Registry
+   ------------------------------------------------------------ */
+
+/*
+ * An owner lives in shard ownerNameHash(name) % OWNER_SHARDS: a circular ring kept in
+ * listOrder plus a chained hash index, so a name lookup touches one bucket. The
+ * numbered listing, printOwnersCircular and the server's LIST walk an OwnerCursor,
+ * which merges the shard rings on the fly. No one ring holds every owner any more.
+ */
+
+typedef enum
+{
+    OWNERS_FORWARD,  // Listing order
+    OWNERS_BACKWARD, // Listing order, last owner first
+    OWNERS_BY_NAME   // Name order (each shard ring must already be sorted by name)
+} OwnerWalk;
+
+typedef struct
+{
+    OwnerNode *next[OWNER_SHARDS]; // Each shard's next owner, NULL once it is used up
+    OwnerWalk walk;
+} OwnerCursor;
+
+/**
+ * @brief Hash an owner name (32-bit FNV-1a).
+ * @param name owner name
+ * @return hash; the low bits select the shard, the rest the index bucket
+ */
+uint32_t ownerNameHash(const char *name);
+
+/**
+ * @brief Start a merged walk over every shard.
+ * @param cursor cursor to initialize
+ * @param walk order to produce
+ * Why we made it: Shards never share a ring, so global order is rebuilt by a k-way merge.
+ */
+void ownerCursorStart(OwnerCursor *cursor, OwnerWalk walk);
+
+/**
+ * @brief Next owner of a merged walk; the registry must not change during the walk.
+ * @param cursor cursor from ownerCursorStart
+ * @return next owner or NULL at the end
+ */
+OwnerNode *ownerCursorNext(OwnerCursor *cursor);
+
+/* ------------------------------------------------------------
+   25) Multi-Merge (Parallel Flatten + K-Way Heap Merge)
+   ------------------------------------------------------------ */
+
+typedef void (*ParallelTask)(int index, void *ctx);
+
+/**
+ * @brief Run task(0) .. task(count - 1) on up to `threads` threads, the caller included.
+ * @param count number of tasks
+ * @param threads threads wanted (clamped to PARALLEL_THREADS and count)
+ * @param task function receiving the task index and ctx
+ * @param ctx shared context
+ * Why we made it: Each task claims the next index, so uneven tasks still balance out.
+ */
+void parallelFor(int count, int threads, ParallelTask task, void *ctx);
+
+/**
+ * @brief Fold many owners' Pokedexes into ownerIn's in one pass; the others are untouched.
+ * @param ownerIn owner that receives the Pokemon (keeps an undo snapshot)
+ * @param owners owners whose Pokemon are copied (distinct, not ownerIn)
+ * @param count number of owners
+ * @return number of Pokemon ownerIn ends up with, or -1 if out of memory (nothing changed)
+ * Why we made it: Flattening runs in parallel; one heap merge drops duplicate IDs and the
+ * tree is built balanced once, instead of re-inserting everything pair by pair.
+ */
+int mergePokedexesInto(OwnerNode *ownerIn, OwnerNode **owners, int count);
+
+/**
+ * @brief Merge many owners into ownerIn, then unlink and free them all.
+ * @param ownerIn owner that keeps the merged Pokedex
+ * @param owners owners that are removed (distinct, not ownerIn)
+ * @param count number of owners
+ * @return number of Pokemon ownerIn ends up with, or -1 if out of memory (nothing changed)
+ */
+int mergeManyOwners(OwnerNode *ownerIn, OwnerNode **owners, int count);
+
+/**
+ * @brief Menu entry: merge a list of owners into one, removing them.
+ * Why we made it: Consolidation folds hundreds of accounts into one owner at a time.
+ */
+void mergeManyMenu(void);
+
+/* ------------------------------------------------------------
+   26) Parallel Traversal (Work-Stealing)
+   ------------------------------------------------------------ */
+
+/*
+ * A reducer folds live nodes into one partial result per worker thread, and the
+ * partials are then combined. Workers see nodes in no fixed order, so visit() and
+ * combine() must give the same answer whatever the order.
+ */
+typedef struct {
+    size_t stateSize;                                               // Bytes in one partial result
+    void (*init)(void *state);                                      // Start an empty partial result
+    void (*visit)(void *state, const PokemonNode *node, void *ctx); // Fold one live node in
+    void (*combine)(void *into, const void *from);                  // Fold one partial into another
+} TraversalReducer;
+
+#define POKEMON_TYPE_COUNT (ICE + 1)
+
+typedef struct {
+    long pokemon;
+    long typeCounts[POKEMON_TYPE_COUNT];
+    long totalHp;
+    long totalAttack;
+    const PokemonData *strongest; // Highest fight score, ties to the lower ID; NULL if no Pokemon
+} PokedexStats;
+
+/**
+ * @brief Run a reducer over every live node of many trees, on several threads when it pays.
+ * @param roots tree roots (NULL entries are skipped)
+ * @param count number of roots
+ * @param reducer how to build, fill and combine partial results
+ * @param ctx caller data handed to every visit() call
+ * @param result receives the combined result (reducer->stateSize bytes)
+ * Why we made it: Idle workers steal split-off subtrees from busy ones, so a few big
+ * Pokedexes among many small ones don't leave the other cores waiting.
+ */
+void parallelTraverse(PokemonNode *const *roots, int count, const TraversalReducer *reducer,
+                      void *ctx, void *result);
+
+/**
+ * @brief Type histogram and HP/attack totals over many Pokedexes.
+ * @param roots tree roots (NULL entries are skipped)
+ * @param count number of roots
+ * @param stats receives the totals
+ */
+void collectPokedexStats(PokemonNode *const *roots, int count, PokedexStats *stats);
+
+/**
+ * @brief Print statistics gathered by collectPokedexStats.
+ * @param out destination stream
+ * @param stats totals to print
+ * @param owners number of owners the totals cover
+ */
+void writePokedexStats(FILE *out, const PokedexStats *stats, size_t owners);
+
+/**
+ * @brief Menu entry: statistics over every owner's Pokedex.
+ * Why we made it: One summary of the whole registry instead of displaying each owner.
+ */
+void pokedexStatsMenu(void);
+
+/* ------------------------------------------------------------
+   27) Pipelined Scripted Runs (SPSC Rings)
+   ------------------------------------------------------------ */
+
+// Bounded byte ring between exactly one producer thread and one consumer thread
+typedef struct {
+    char *buf;
+    size_t capacity; // Power of two
+    size_t head;     // Bytes read so far; only the consumer moves it (atomic)
+    size_t tail;     // Bytes written so far; only the producer moves it (atomic)
+    int closed;      // Either side hung up (atomic)
+} SpscRing;
+
+/**
+ * @brief Set up an empty ring.
+ * @param ring ring to initialize
+ * @param capacity size in bytes, a power of two
+ * @return 1 on success, 0 if out of memory
+ */
+int spscInit(SpscRing *ring, size_t capacity);
+
+/**
+ * @brief Free a ring's buffer once both sides are done with it.
+ * @param ring ring to destroy
+ */
+void spscDestroy(SpscRing *ring);
+
+/**
+ * @brief Producer side: copy bytes in, waiting for room.
+ * @param ring ring to write to
+ * @param data bytes to copy
+ * @param len number of bytes; up to the capacity they become visible all at once
+ * @return len, or fewer if the ring was closed meanwhile
+ * Why we made it: No locks, just one acquire/release pair per batch of bytes.
+ */
+size_t spscWrite(SpscRing *ring, const char *data, size_t len);
+
+/**
+ * @brief Consumer side: copy out whatever is there, waiting for at least one byte.
+ * @param ring ring to read from
+ * @param out destination buffer
+ * @param max room in out
+ * @return bytes copied, 0 once the ring is closed and drained
+ */
+size_t spscRead(SpscRing *ring, char *out, size_t max);
+
+/**
+ * @brief Hang up: the reader sees end of data after draining, the writer stops.
+ * @param ring ring to close
+ */
+void spscClose(SpscRing *ring);
+
+/**
+ * @brief Run the menus with input reading and output writing on their own threads.
+ * @return process exit status
+ * Why we made it: A scripted run then costs its slowest stage, not the sum of reading,
+ * executing and writing.
+ */
+int runPipeline(void);
+
+/* ------------------------------------------------------------
+   28) Streaming Export (CSV / JSON Lines)
+   ------------------------------------------------------------ */
+
+typedef enum
+{
+    EXPORT_CSV,  // owner,id,name,type,hp,attack,can_evolve - one row per Pokemon
+    EXPORT_JSONL // {"owner":...,"pokemon":[...]} - one line per owner
+} ExportFormat;
+
+/**
+ * @brief Write every owner and their Pokemon, with species stats, to a stream.
+ * @param out destination stream
+ * @param format CSV or JSON Lines
+ * @return number of owners written, or -1 if writing failed
+ * Why we made it: Analytics wants machine-readable rows. One pass over the owners and
+ * trees through a fixed-size buffer keeps memory flat however many owners there are.
+ */
+long exportOwners(FILE *out, ExportFormat format);
+
+/**
+ * @brief Menu entry: export all owners to a CSV or JSON Lines file.
+ */
+void exportOwnersMenu(void);
+
+/* ------------------------------------------------------------
+   29) Parallel Bulk Import (CSV)
+   ------------------------------------------------------------ */
+
+typedef struct {
+    int imported;
+    int duplicates;    // Names already taken, or repeated in the file (first one wins)
+    int badLines;      // Empty name, or a species that isn't a valid ID or name
+    long firstBadLine; // 1-based, 0 if every line was fine
+} ImportReport;
+
+/**
+ * @brief Create owners from a file of "name,species,species,..." lines.
+ * A name holding a comma or a quote is quoted CSV-style ("q,x"), as exports write it.
+ * @param path file to read
+ * @param report receives the counts
+ * @return 0 on success, -1 if the file can't be read or memory runs out (nothing imported)
+ * Why we made it: Onboarding thousands of trainers one menu prompt at a time is too
+ * slow. The file is mapped and parsed in parallel chunks, and the owners are linked
+ * in one batch.
+ */
+int importOwnersFromFile(const char *path, ImportReport *report);
+
+/**
+ * @brief Menu entry: import owners from a CSV file.
+ */
+void importOwnersMenu(void);
+
+/* ------------------------------------------------------------
+   30) Compressed Snapshots (Bitmap or Delta-Varint per Owner)
+   ------------------------------------------------------------ */
+
+/*
+ * Snapshot file layout (varints are unsigned LEB128: 7 bits per byte, low first):
+ *   "PKDX" 0x01             magic and version
+ *   varint ownerCount
+ *   per owner, in listing order:
+ *     varint nameLength, name bytes (no terminator)
+ *     tag byte: 0        -> SNAPSHOT_BITMAP_BYTES follow, bit (id - 1) set per species
+ *               n + 1    -> n varints follow: the first ID, then the gaps between
+ *                           consecutive IDs in ascending order
+ * Each owner gets whichever encoding is smaller, so a few Pokemon cost a few bytes
+ * and a full Pokedex costs 20.
+ */
+#define SNAPSHOT_BITMAP_BYTES ((POKEDEX_SIZE + 7) / 8)
+
+/**
+ * @brief Write every owner's name and Pokedex to a snapshot stream.
+ * @param out destination stream
+ * @return bytes written, or -1 if writing failed
+ * Why we made it: Species IDs are small and dense, so millions of owners fit in a
+ * file small enough to stay in the page cache.
+ */
+long saveOwnersSnapshot(FILE *out);
+
+/**
+ * @brief Add the owners stored in a snapshot file; names already taken are skipped.
+ * @param path snapshot file
+ * @param report receives the counts (badLines stays 0)
+ * @return 0 on success, -1 if the file can't be read or memory runs out, -2 if it isn't
+ * a valid snapshot (nothing loaded in either case)
+ * Why we made it: Trees are built straight from the decoded ascending IDs, with no
+ * per-ID inserts.
+ */
+int loadOwnersSnapshot(const char *path, ImportReport *report);
+
+/**
+ * @brief Menu entry: save all owners to a snapshot file.
+ */
+void saveSnapshotMenu(void);
+
+/**
+ * @brief Menu entry: load owners from a snapshot file.
+ */
+void loadSnapshotMenu(void);
+
+/* ------------------------------------------------------------
+   31) Benchmarks (--bench)
+   ------------------------------------------------------------ */
+
+/**
+ * @brief Time the traversal and Pokedex engine variants against each other.
+ * @return process exit status (non-zero if the benchmark trees couldn't be built)
+ * Why we made it: Claims like "Morris costs little" or "specialized walkers are faster"
+ * should come with numbers from this machine.
+ */
+int runBench(void);
+
+// Array of Pokemon data
+static const PokemonData pokedex[] = {
+    {1, "Bulbasaur", GRASS, 45, 49, CAN_EVOLVE},
+    {2, "Ivysaur", GRASS, 60, 62, CAN_EVOLVE},
+    {3, "Venusaur", GRASS, 80, 82, CANNOT_EVOLVE},
+    {4, "Charmander", FIRE, 39, 52, CAN_EVOLVE},
+    {5, "Charmeleon", FIRE, 58, 64, CAN_EVOLVE},
+    {6, "Charizard", FIRE, 78, 84, CANNOT_EVOLVE},
+    {7, "Squirtle", WATER, 44, 48, CAN_EVOLVE},
+    {8, "Wartortle", WATER, 59, 63, CAN_EVOLVE},
+    {9, "Blastoise", WATER, 79, 83, CANNOT_EVOLVE},
+    {10, "Caterpie", BUG, 45, 30, CAN_EVOLVE},
+    {11, "Metapod", BUG, 50, 20, CAN_EVOLVE},
+    {12, "Butterfree", BUG, 60, 45, CANNOT_EVOLVE},
+    {13, "Weedle", BUG, 40, 35, CAN_EVOLVE},
+    {14, "Kakuna", BUG, 45, 25, CAN_EVOLVE},
+    {15, "Beedrill", BUG, 65, 90, CANNOT_EVOLVE},
+    {16, "Pidgey", NORMAL, 40, 45, CAN_EVOLVE},
+    {17, "Pidgeotto", NORMAL, 63, 60, CAN_EVOLVE},
+    {18, "Pidgeot", NORMAL, 83, 80, CANNOT_EVOLVE},
+    {19, "Rattata", NORMAL, 30, 56, CAN_EVOLVE},
+    {20, "Raticate", NORMAL, 55, 81, CANNOT_EVOLVE},
+    {21, "Spearow", NORMAL, 40, 60, CAN_EVOLVE},
+    {22, "Fearow", NORMAL, 65, 90, CANNOT_EVOLVE},
+    {23, "Ekans", POISON, 35, 60, CAN_EVOLVE},
+    {24, "Arbok", POISON, 60, 85, CANNOT_EVOLVE},
+    {25, "Pikachu", ELECTRIC, 35, 55, CAN_EVOLVE},
+    {26, "Raichu", ELECTRIC, 60, 90, CANNOT_EVOLVE},
+    {27, "Sandshrew", GROUND, 50, 75, CAN_EVOLVE},
+    {28, "Sandslash", GROUND, 75, 100, CANNOT_EVOLVE},
+    {29, "NidoranF", POISON, 55, 47, CAN_EVOLVE},
+    {30, "Nidorina", POISON, 70, 62, CAN_EVOLVE},
+    {31, "Nidoqueen", POISON, 90, 92, CANNOT_EVOLVE},
+    {32, "NidoranM", POISON, 46, 57, CAN_EVOLVE},
+    {33, "Nidorino", POISON, 61, 72, CAN_EVOLVE},
+    {34, "Nidoking", POISON, 81, 102, CANNOT_EVOLVE},
+    {35, "Clefairy", FAIRY, 70, 45, CAN_EVOLVE},
+    {36, "Clefable", FAIRY, 95, 70, CANNOT_EVOLVE},
+    {37, "Vulpix", FIRE, 38, 41, CAN_EVOLVE},
+    {38, "Ninetales", FIRE, 73, 76, CANNOT_EVOLVE},
+    {39, "Jigglypuff", NORMAL, 115, 45, CAN_EVOLVE},
+    {40, "Wigglytuff", NORMAL, 140, 70, CANNOT_EVOLVE},
+    {41, "Zubat", POISON, 40, 45, CAN_EVOLVE},
+    {42, "Golbat", POISON, 75, 80, CAN_EVOLVE},
+    {43, "Oddish", GRASS, 45, 50, CAN_EVOLVE},
+    {44, "Gloom", GRASS, 60, 65, CAN_EVOLVE},
+    {45, "Vileplume", GRASS, 75, 80, CANNOT_EVOLVE},
+    {46, "Paras", BUG, 35, 70, CAN_EVOLVE},
+    {47, "Parasect", BUG, 60, 95, CANNOT_EVOLVE},
+    {48, "Venonat", BUG, 60, 55, CAN_EVOLVE},
+    {49, "Venomoth", BUG, 70, 65, CANNOT_EVOLVE},
+    {50, "Diglett", GROUND, 10, 55, CAN_EVOLVE},
+    {51, "Dugtrio", GROUND, 35, 80, CANNOT_EVOLVE},
+    {52, "Meowth", NORMAL, 40, 45, CAN_EVOLVE},
+    {53, "Persian", NORMAL, 65, 70, CANNOT_EVOLVE},
+    {54, "Psyduck", WATER, 50, 52, CAN_EVOLVE},
+    {55, "Golduck", WATER, 80, 82, CANNOT_EVOLVE},
+    {56, "Mankey", FIGHTING, 40, 80, CAN_EVOLVE},
+    {57, "Primeape", FIGHTING, 65, 105, CANNOT_EVOLVE},
+    {58, "Growlithe", FIRE, 55, 70, CAN_EVOLVE},
+    {59, "Arcanine", FIRE, 90, 110, CANNOT_EVOLVE},
+    {60, "Poliwag", WATER, 40, 50, CAN_EVOLVE},
+    {61, "Poliwhirl", WATER, 65, 65, CAN_EVOLVE},
+    {62, "Poliwrath", WATER, 90, 95, CANNOT_EVOLVE},
+    {63, "Abra", PSYCHIC, 25, 20, CAN_EVOLVE},
+    {64, "Kadabra", PSYCHIC, 40, 35, CAN_EVOLVE},
+    {65, "Alakazam", PSYCHIC, 55, 50, CANNOT_EVOLVE},
+    {66, "Machop", FIGHTING, 70, 80, CAN_EVOLVE},
+    {67, "Machoke", FIGHTING, 80, 100, CAN_EVOLVE},
+    {68, "Machamp", FIGHTING, 90, 130, CANNOT_EVOLVE},
+    {69, "Bellsprout", GRASS, 50, 75, CAN_EVOLVE},
+    {70, "Weepinbell", GRASS, 65, 90, CAN_EVOLVE},
+    {71, "Victreebel", GRASS, 80, 105, CANNOT_EVOLVE},
+    {72, "Tentacool", WATER, 40, 40, CAN_EVOLVE},
+    {73, "Tentacruel", WATER, 80, 70, CANNOT_EVOLVE},
+    {74, "Geodude", ROCK, 40, 80, CAN_EVOLVE},
+    {75, "Graveler", ROCK, 55, 95, CAN_EVOLVE},
+    {76, "Golem", ROCK, 80, 120, CANNOT_EVOLVE},
+    {77, "Ponyta", FIRE, 50, 85, CAN_EVOLVE},
+    {78, "Rapidash", FIRE, 65, 100, CANNOT_EVOLVE},
+    {79, "Slowpoke", WATER, 90, 65, CAN_EVOLVE},
+    {80, "Slowbro", WATER, 95, 75, CANNOT_EVOLVE},
+    {81, "Magnemite", ELECTRIC, 25, 35, CAN_EVOLVE},
+    {82, "Magneton", ELECTRIC, 50, 60, CANNOT_EVOLVE},
+    {83, "Farfetch'd", NORMAL, 52, 65, CANNOT_EVOLVE},
+    {84, "Doduo", NORMAL, 35, 85, CAN_EVOLVE},
+    {85, "Dodrio", NORMAL, 60, 110, CANNOT_EVOLVE},
+    {86, "Seel", WATER, 65, 45, CAN_EVOLVE},
+    {87, "Dewgong", WATER, 90, 70, CANNOT_EVOLVE},
+    {88, "Grimer", POISON, 80, 80, CAN_EVOLVE},
+    {89, "Muk", POISON, 105, 105, CANNOT_EVOLVE},
+    {90, "Shellder", WATER, 30, 65, CAN_EVOLVE},
+    {91, "Cloyster", WATER, 50, 95, CANNOT_EVOLVE},
+    {92, "Gastly", GHOST, 30, 35, CAN_EVOLVE},
+    {93, "Haunter", GHOST, 45, 50, CAN_EVOLVE},
+    {94, "Gengar", GHOST, 60, 65, CANNOT_EVOLVE},
+    {95, "Onix", ROCK, 35, 45, CANNOT_EVOLVE},
+    {96, "Drowzee", PSYCHIC, 60, 48, CAN_EVOLVE},
+    {97, "Hypno", PSYCHIC, 85, 73, CANNOT_EVOLVE},
+    {98, "Krabby", WATER, 30, 105, CAN_EVOLVE},
+    {99, "Kingler", WATER, 55, 130, CANNOT_EVOLVE},
+    {100, "Voltorb", ELECTRIC, 40, 30, CAN_EVOLVE},
+    {101, "Electrode", ELECTRIC, 60, 50, CANNOT_EVOLVE},
+    {102, "Exeggcute", GRASS, 60, 40, CAN_EVOLVE},
     {103, "Exeggutor", GRASS, 95, 95, CANNOT_EVOLVE},
     {104, "Cubone", GROUND, 50, 50, CAN_EVOLVE},
     {105, "Marowak", GROUND, 60, 80, CANNOT_EVOLVE},
@@ -618,4 +1923,7 @@ static const PokemonData pokedex[] = {
     {150, "Mewtwo", PSYCHIC, 106, 110, CANNOT_EVOLVE},
     {151, "Mew", PSYCHIC, 100, 100, CANNOT_EVOLVE}};
 
+// Number of species in the pokedex (valid IDs are 1..POKEDEX_SIZE)
+#define POKEDEX_SIZE ((int)(sizeof(pokedex) / sizeof(pokedex[0])))
+
 #endif // EX6_H